@@ -28,8 +28,9 @@ public:
 	double costs(unsigned int symbol);
 	void encode(unsigned int symbol);
 	unsigned int decode();
-	static bool compUpper(RANGETYPE value, DistributionElement& d) { return value < d.getRangeValue(); };
-	static bool compLower(DistributionElement& d, RANGETYPE value) { return d.getRangeValue() < value; };
+	// the binary search in decode() evaluates the distribution many times per symbol: bind statically instead of calling through DistributionElement
+	static bool compUpper(RANGETYPE value, ImplicitDistributionElement& d) { return value < d.ImplicitDistributionElement::getRangeValue(); };
+	static bool compLower(ImplicitDistributionElement& d, RANGETYPE value) { return d.ImplicitDistributionElement::getRangeValue() < value; };
 
 private:
 	const RANGETYPE rangemin, rangemax, rangehalf, rangequarter, rangethreequarter;
@@ -0,0 +1,57 @@
+// Copyright (c) 2015 Siemens AG, Author: Andreas Weinlich
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <iostream>
+#include <vector>
+
+#include "vanilcDefinitions.h"
+#include "vanilcConfig.h"
+
+namespace vanilc {
+
+using namespace std;
+using namespace cv;
+
+// codes many images (or bitstreams) with one configuration: whole files are distributed over the threads, the largest ones first
+class BatchCoder {
+public:
+	BatchCoder(Config& config);
+	unsigned int run(); // returns the number of files that could not be coded
+
+private:
+	struct Job {
+		string source, destination;
+		double cost; // estimated coding time (file size: the predictor is the same for all files)
+		bool operator<(const Job& other) const { return cost > other.cost; }; // largest first
+	};
+
+	void collectFiles(const string& source, vector<string>& files) const;
+	void codeJob(const Job& job);
+	static string getFilename(const string& path);
+
+	Config* config;
+	bool encoding, verbose;
+	vector<Job> jobs;
+	unsigned int failed;
+	Mutex outputMutex; // summary lines of different threads must not be mixed
+
+	friend class ParallelBatchCoder;
+};
+
+class ParallelBatchCoder : public ParallelLoopBody {
+public:
+	ParallelBatchCoder(BatchCoder& batchCoder) : batchCoder(&batchCoder) {};
+	void operator()(const Range& range) const;
+
+private:
+	BatchCoder* batchCoder;
+};
+
+} // end namespace vanilc
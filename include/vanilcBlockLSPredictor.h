@@ -0,0 +1,60 @@
+// Copyright (c) 2015 Siemens AG, Author: Andreas Weinlich
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <iostream>
+
+#include "vanilcDefinitions.h"
+#include "vanilcPredictor.h"
+
+namespace vanilc {
+
+using namespace std;
+using namespace cv;
+
+// forward-adaptive least-squares prediction: the encoder solves one system of equations per block of a slice on the block data itself and transmits
+// the quantized coefficients, so that the decoder only computes a dot product per pixel (pixels without full neighborhood use the neighborhood mean)
+class BlockLSPredictionComputer : public Computer {
+public:
+	BlockLSPredictionComputer(int blockSize, int coefficientBits, double regularization, int solver) :
+		blockSize(blockSize), coefficientBits(coefficientBits), regularization(regularization), solver(solver) {};
+	double compute(const Point3i& currentPos, Context* context);
+	bool isRecursive() const { return true; }; // the coefficients of a slice are coded before its first pixel
+
+	int getBlockSize() const { return blockSize; };
+	int getCoefficientBits() const { return coefficientBits; };
+	// quantized coefficients (CV_32S, one row per block of a slice in raster order, one column per element of the full neighborhood)
+	void resetCoefficients(const Context& context); // zero coefficients for the image and neighborhood of the context
+	void estimateCoefficients(unsigned int slice, const Context& context); // encoder: least-squares solution for every block
+	Mat& getQuantizedCoefficients() { return quantizedCoefficients; };
+	int predictCoefficient(int block, int i) const; // from the already known coefficients of the neighboring blocks
+	void updateCoefficients(); // dequantize after the quantized coefficients were changed (decoder)
+	int getDegreesOfFreedom(const Point3i& currentPos) const; // number of pixels of the block minus number of coefficients
+
+private:
+	int blockSize, coefficientBits;
+	double regularization;
+	int solver;
+	int blocksPerRow;
+	Mat quantizedCoefficients, blockCoefficients;
+	Mat sampleVector;
+	int height, width;
+};
+
+class BlockLSDegreesOfFreedomComputer : public Computer {
+public:
+	BlockLSDegreesOfFreedomComputer(const BlockLSPredictionComputer* predictionComputer) : predictionComputer(predictionComputer) {};
+	double compute(const Point3i& currentPos, Context* context) { return predictionComputer->getDegreesOfFreedom(currentPos); };
+
+private:
+	const BlockLSPredictionComputer* predictionComputer;
+};
+
+} // end namespace vanilc
@@ -0,0 +1,52 @@
+// Copyright (c) 2015 Siemens AG, Author: Andreas Weinlich
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <iostream>
+#include <vector>
+#include <functional>
+#include <algorithm>
+
+namespace vanilc {
+
+using namespace std;
+using namespace cv;
+
+// binary heap with a fixed number of elements for top-K selection: top() is the largest element with respect to Compare (like std::priority_queue),
+// i. e. with the default the worst of the K smallest values seen so far; replacing it costs O(log K) instead of a search or a sort over all K elements
+template<typename T, class Compare = less<T> >
+class BoundedHeap {
+public:
+	BoundedHeap(int capacity, const T& value, const Compare& compare = Compare()) : elements(capacity, value), compare(compare) {};
+	template<class Iterator> BoundedHeap(Iterator first, Iterator last, const Compare& compare = Compare()) : elements(first, last), compare(compare) {
+		make_heap(elements.begin(), elements.end(), this->compare); };
+
+	void reset(const T& value) { fill(elements.begin(), elements.end(), value); }; // all elements equal -> valid heap
+	int size() const { return (int)elements.size(); };
+	const T& top() const { return elements[0]; };
+	const T& operator[](int i) const { return elements[i]; }; // heap order, not sorted
+
+	void replaceTop(const T& value) { // sift down from the root
+		const int n = (int)elements.size();
+		int i = 0;
+		for(int child = 1; child < n; child = 2 * i + 1) {
+			if(child + 1 < n && compare(elements[child], elements[child + 1])) ++child; // larger child
+			if(!compare(value, elements[child])) break;
+			elements[i] = elements[child];
+			i = child;
+		}
+		elements[i] = value;
+	};
+
+private:
+	vector<T> elements;
+	Compare compare;
+};
+
+} // end namespace vanilc
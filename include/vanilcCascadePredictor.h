@@ -0,0 +1,80 @@
+// Copyright (c) 2015 Siemens AG, Author: Andreas Weinlich
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <iostream>
+
+#include "vanilcPredictor.h"
+#include "vanilcExponentialVarianceComputer.h"
+
+namespace vanilc {
+
+using namespace std;
+using namespace cv;
+
+// sends each pixel to one of several complete predictors (stages) according to the activity of its causal neighborhood: the standard deviation of the
+// neighboring pixels (in 8-bit units) selects a cheap stage in flat regions, FASTLS for moderate and WLS only for strong texture and edges
+class CascadePredictionComputer : public Computer {
+public:
+	enum Stage { STAGE_FLAT, STAGE_MODERATE, STAGE_TEXTURE, NUMBER_OF_STAGES };
+
+	// takes ownership of the stage predictors (the moderate and texture stages must use the same neighborhood as the cascade predictor)
+	CascadePredictionComputer(Predictor* flatPredictor, Predictor* moderatePredictor, Predictor* texturePredictor, double flatThreshold, double textureThreshold);
+	~CascadePredictionComputer();
+	void init();
+	double compute(const Point3i& currentPos, Context* context);
+	bool isRecursive() const;
+	void advance(const Point3i& currentPos, Context* context);
+
+	// stage that predicted the current pixel (NULL if the prediction computer was skipped, e.g. by an exact match)
+	Predictor* getCurrentStage() const { return currentStage < 0 ? NULL : stages[currentStage]; };
+	bool isLeastSquaresStage() const { return currentStage > STAGE_FLAT; }; // the current stage computes the LS variance
+
+private:
+	double computeActivity(const Point3i& currentPos, Context* context);
+	void skipStages(const Point3i& currentPos, int chosenStage); // recursive stages must see every pixel
+
+	Predictor* stages[NUMBER_OF_STAGES];
+	double flatThreshold, textureThreshold;
+	double activityScale; // converts intensities to 8-bit units
+	int currentStage;
+	bool buffersShared; // stages read the neighborhood buffer of the cascade predictor
+	Mat sampleVector;
+};
+
+// LS variance of the least-squares stages; pixels of the flat stage (and exact matches) use the exponential estimate over all previous predictions
+class CascadeVarianceComputer : public Computer {
+public:
+	CascadeVarianceComputer(const CascadePredictionComputer* predictionComputer) : predictionComputer(predictionComputer) {};
+	void init() { fallbackComputer.setPredictor(predictor); };
+	double compute(const Point3i& currentPos, Context* context);
+	bool isRecursive() const { return true; };
+
+private:
+	const CascadePredictionComputer* predictionComputer;
+	ExponentialVarianceComputer fallbackComputer;
+};
+
+// pixels of the flat stage (and exact matches) keep the degrees of freedom of the last least-squares estimate
+class CascadeDegreesOfFreedomComputer : public Computer {
+public:
+	CascadeDegreesOfFreedomComputer(const CascadePredictionComputer* predictionComputer) : predictionComputer(predictionComputer) {};
+	void init() { degreesOfFreedom = 1.0; };
+	double compute(const Point3i& currentPos, Context* context) {
+		if(predictionComputer->isLeastSquaresStage()) degreesOfFreedom = predictionComputer->getCurrentStage()->computeDegreesOfFreedom();
+		return degreesOfFreedom; };
+	bool isRecursive() const { return true; };
+
+private:
+	const CascadePredictionComputer* predictionComputer;
+	double degreesOfFreedom;
+};
+
+} // end namespace vanilc
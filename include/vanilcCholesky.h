@@ -0,0 +1,76 @@
+// Copyright (c) 2015 Siemens AG, Author: Andreas Weinlich
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <iostream>
+
+namespace vanilc {
+
+using namespace std;
+using namespace cv;
+
+// largest system that is solved with a fixed-size factorization on the stack (larger ones are passed to OpenCV)
+const int MAX_FIXED_CHOLESKY_SIZE = 32;
+
+// solves A x = b for a symmetric positive definite M x M matrix A (only its lower triangle is read) and N right hand sides;
+// performs exactly the operations of OpenCV's DECOMP_CHOLESKY (identical results) but the dimensions are known at compile time
+template<int M, int N>
+bool choleskySolve(const double* A, size_t astep, const double* b, size_t bstep, double* x, size_t xstep) {
+	double L[M * M];
+	int i, j, k;
+	double s;
+	for(i = 0; i < M; ++i) {
+		for(j = 0; j < i; ++j) {
+			s = A[i * astep + j];
+			for(k = 0; k < j; ++k) s -= L[i * M + k] * L[j * M + k];
+			L[i * M + j] = s * L[j * M + j];
+		}
+		s = A[i * astep + i];
+		for(k = 0; k < i; ++k) s -= L[i * M + k] * L[i * M + k];
+		if(s < numeric_limits<double>::epsilon()) return false;
+		L[i * M + i] = 1.0 / sqrt(s); // inverse diagonal
+	}
+	for(i = 0; i < M; ++i) // L y = b
+		for(j = 0; j < N; ++j) {
+			s = b[i * bstep + j];
+			for(k = 0; k < i; ++k) s -= L[i * M + k] * x[k * xstep + j];
+			x[i * xstep + j] = s * L[i * M + i];
+		}
+	for(i = M - 1; i >= 0; --i) // L^T x = y
+		for(j = 0; j < N; ++j) {
+			s = x[i * xstep + j];
+			for(k = M - 1; k > i; --k) s -= L[k * M + i] * x[k * xstep + j];
+			x[i * xstep + j] = s * L[i * M + i];
+		}
+	return true;
+} // end choleskySolve
+
+// selects the instantiation for the runtime dimension m <= M
+template<int M, int N>
+struct FixedCholeskySolver {
+	static bool solve(int m, const double* A, size_t astep, const double* b, size_t bstep, double* x, size_t xstep) {
+		return (m == M ? choleskySolve<M, N>(A, astep, b, bstep, x, xstep) : FixedCholeskySolver<M - 1, N>::solve(m, A, astep, b, bstep, x, xstep));
+	};
+};
+
+template<int N>
+struct FixedCholeskySolver<0, N> {
+	static bool solve(int, const double*, size_t, const double*, size_t, double*, size_t) { return true; };
+};
+
+// drop-in replacement for solve(A, B, X, DECOMP_CHOLESKY) with CV_64F matrices: no memory allocation for the least-squares systems of the predictors
+inline bool solveCholesky(const Mat& A, const Mat& B, Mat& X) {
+	if(A.rows > MAX_FIXED_CHOLESKY_SIZE || A.rows != A.cols || B.cols != 2 || A.type() != CV_64F || B.type() != CV_64F)
+		return solve(A, B, X, DECOMP_CHOLESKY);
+	X.create(A.rows, B.cols, CV_64F);
+	return FixedCholeskySolver<MAX_FIXED_CHOLESKY_SIZE, 2>::solve(A.rows,
+		A.ptr<double>(), A.step1(), B.ptr<double>(), B.step1(), X.ptr<double>(), X.step1());
+} // end solveCholesky
+
+} // end namespace vanilc
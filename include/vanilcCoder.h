@@ -22,6 +22,8 @@
 #include "vanilcConfig.h"
 #include "vanilcRawIO.h"
 #include "vanilcPredictorConstructor.h"
+#include "vanilcParallelPredictor.h"
+#include "vanilcSubstream.h"
 #include "vanilcUniformDistributionFunction.h"
 #include "vanilcLaplaceDistributionFunction.h"
 #include "vanilcNormalDistributionFunction.h"
@@ -56,6 +58,20 @@ public:
 
 private:
 	void createPredictor();
+	Predictor* constructPredictor(Context* weightingContext);
+	Predictor* createWorker(unsigned int maxval, Context*& workerWeightingContext, bool ownBuffer = false);
+	void createWorkers(unsigned int slice, unsigned int maxval);
+	#ifdef ARITHMETIC_CODING
+		void createDistribution(DistributionMaker& distributionMaker, unsigned int maxval, const Point3i& firstPosition = Point3i(0, 0, 0));
+	#endif
+	Substream* createSubstream(unsigned int slice, const Range& rows, unsigned int maxval, bool ownBuffer);
+	void codeSubstreamSizes(vector<unsigned int>& sizes, bool encoding);
+	void codeSubstreams(bool encoding, unsigned int maxval, unsigned int width, unsigned int height, unsigned int depth);
+	void codeSubstreamSteps(bool encoding, unsigned int maxval, unsigned int width, unsigned int height, unsigned int depth, vector<EntropyCoder::bitqueue>& bitstreams);
+	void codeTiles(bool encoding, unsigned int maxval, vector<EntropyCoder::bitqueue>& bitstreams);
+	void codeTile(unsigned int tile, bool encoding, unsigned int maxval, EntropyCoder::bitqueue& bitstream);
+	void codePixels(char encoding, unsigned int maxval, unsigned int width, unsigned int height, unsigned int depth);
+	void codeBlockCoefficients(unsigned int slice, char encoding);
 	void convertTo2D(const Mat& image3D, Mat& image2D, unsigned int slice = 0) const;
 	Mat transp(const Mat& image) const;
 	void codeHeader(bool encoding, unsigned int &maxval, unsigned int &width, unsigned int &height, unsigned int &depth);
@@ -64,17 +80,36 @@ private:
 	Config* config;
 	bool verbose;
 	double sparsify_distribution;
+	unsigned int threads;
 
 	Mat image, predictionImage, varianceImage, dofImage;
 	unsigned int type, bitdepth;
 	unsigned int imageDirection; // 1 if image is being transposed before coding
 	Context context, weightingContext;
 	Predictor* predictor;
+	ParallelPredictor parallelPredictor; // worker predictors for parallel encoding
 	#ifdef ARITHMETIC_CODING
 		GenericDistributionCoder* entropyCoder;
+		double regDistVar, regDistRatio; // parameters of the regularization distribution
 	#elif defined GOLOMB_CODING
 		RiceGolombCoder* entropyCoder;
 	#endif
+
+	friend class ParallelTileCoder;
+};
+
+// codes independent tiles of the image in parallel
+class ParallelTileCoder : public ParallelLoopBody {
+public:
+	ParallelTileCoder(Coder& coder, bool encoding, unsigned int maxval, vector<EntropyCoder::bitqueue>& bitstreams) :
+		coder(&coder), encoding(encoding), maxval(maxval), bitstreams(&bitstreams) {};
+	void operator()(const Range& range) const;
+
+private:
+	Coder* coder;
+	bool encoding;
+	unsigned int maxval;
+	vector<EntropyCoder::bitqueue>* bitstreams;
 };
 
 class NoUnsignedImageException : public Exception {
@@ -22,9 +22,14 @@ class Predictor;
 
 class Computer {
 public:
+	virtual ~Computer() {}; // computers are deleted by their predictor through this base class
 	void setPredictor(Predictor* predictor) { this->predictor = predictor; };
 	virtual void init() {};
 	virtual double compute(const Point3i& currentPos, Context* context) { return 1.0; }; // defaults to return unity
+	// computers whose result depends on the results for all previous pixels cannot be run in parallel at arbitrary positions
+	virtual bool isRecursive() const { return false; };
+	// update internal state for a pixel without computing a result (used by parallel coders to skip pixels of other threads)
+	virtual void advance(const Point3i& currentPos, Context* context) {};
 
 protected:
 	Predictor* predictor;
@@ -5,20 +5,19 @@
 // The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
 //
 // THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+#pragma once
 
-#include "vanilcInversePriorizedSQDWeightingFunction.h"
+#include <opencv2/opencv.hpp>
+#include <iostream>
 
 namespace vanilc {
 
-double InversePriorizedSQDWeightingFunction::computeWeight(const Mat& regressionPoint) {
-	double distance, result = 0.0, meanRefValue = 0.0, varRefValue = 0.0, meanDstValue = 0.0;
-	const double* regressionPointPtr = regressionPoint.ptr<double>();
-	for(int l = 0; l < referenceRegressionPoint.cols; ++l) {
-		distance = (referenceRegressionPointPtr[l] - *(regressionPointPtr++)) * neighborhoodPriorizationPtr[l];
-		result += distance * distance;
-	}
-	return maxval / (maxval + result * result);
-} // end InversePriorizedSQDWeightingFunction::computeWeight
+using namespace std;
+using namespace cv;
 
-} // end namespace vanilc
+// solves A X = B for a symmetric positive definite matrix A (CV_64F) column by column with the Jacobi preconditioned conjugate gradient method;
+// X must contain the initial guess and receives the solution; returns false if a residual norm is still larger than tolerance times the norm of
+// its right hand side after maxIterations iterations (X then contains the last iterate)
+bool solveConjugateGradient(const Mat& A, const Mat& B, Mat& X, int maxIterations, double tolerance);
 
+} // end namespace vanilc
@@ -32,12 +32,17 @@ public:
 		neighborhood(StructuringElement(Mat(), Point3i(-1, -1, -1))), trainingregion(StructuringElement(Mat(), Point3i(-1, -1, -1))),
 		fullNeighborhood(StructuringElement(Mat(), Point3i(-1, -1, -1))), fullTrainingregion(StructuringElement(Mat(), Point3i(-1, -1, -1))),
 		image(NULL), buffer(NULL), imagePosition(Point3i(-1, -1, -1)), contextPosition(Point3i(-1, -1, -1)),
-		border(false), croppedNeighborhood(false), useBuffer(false) {};
+		border(false), croppedNeighborhood(false), useBuffer(false), precision(CV_64F) {};
 	Context(StructuringElement& neighborhood, StructuringElement& trainingregion) :
 		neighborhood(neighborhood), trainingregion(trainingregion),
 		fullNeighborhood(neighborhood), fullTrainingregion(trainingregion),
 		image(NULL), buffer(NULL), imagePosition(Point3i(-1, -1, -1)), contextPosition(Point3i(-1, -1, -1)),
-		border(false), croppedNeighborhood(false), useBuffer(false) {};
+		border(false), croppedNeighborhood(false), useBuffer(false), precision(CV_64F) {};
+	Context(const Context& context) : // the buffer is not copied (see shareBuffer)
+		neighborhood(context.neighborhood), trainingregion(context.trainingregion),
+		fullNeighborhood(context.fullNeighborhood), fullTrainingregion(context.fullTrainingregion),
+		image(context.image), buffer(NULL), imagePosition(context.imagePosition), contextPosition(context.contextPosition),
+		border(context.border), croppedNeighborhood(context.croppedNeighborhood), useBuffer(false), precision(context.precision) {};
 	~Context() { bufferOff(); };
 
 	void setNeighborhood(const StructuringElement& neighborhood) { this->neighborhood = neighborhood; border = true; croppedNeighborhood = true; useBuffer = false; };
@@ -49,6 +54,9 @@ public:
 	const StructuringElement& getTrainingregion() const { return trainingregion; };
 	const StructuringElement& getFullTrainingregion() const { return fullTrainingregion; };
 	void setImage(const Mat* image) { bufferOff(); this->image = image; };
+	// CV_64F or CV_32F: type of the neighborhood buffer and arithmetic precision for predictors that support single precision (context elements are always returned as CV_64F)
+	void setPrecision(int precision) { bufferOff(); this->precision = precision; };
+	int getPrecision() const { return precision; };
 	const Mat* getImage() const { return image; };
 	bool isBorder() const { return border; };
 
@@ -64,9 +72,13 @@ public:
 
 	// buffers already computed context elements but needs lots of memory;
 	// must be turned on manually after each change of image, neighborhood or training region
-	void bufferOn() { if(!buffer) buffer = new Mat(image->total(), neighborhood.getNumberOfElements(), CV_64F, numeric_limits<double>::quiet_NaN()); };
+	void bufferOn() { if(!buffer) buffer = new Mat(image->total(), neighborhood.getNumberOfElements(), precision, numeric_limits<double>::quiet_NaN()); };
 	void bufferOff() { if(buffer) { delete buffer; buffer = NULL; } };
 	bool getBuffered() const { return (bool)buffer; };
+	// use the buffer of another context with identical image and neighborhood (without reference counting: the other context must outlive this one)
+	void shareBuffer(const Context& context) { bufferOff(); if(context.buffer) buffer = new Mat(context.buffer->rows, context.buffer->cols, context.buffer->type(), context.buffer->data); };
+	// fill all buffer rows of the given image rows (and columns) in advance, so that several threads may read from the buffer concurrently
+	void fillBuffer(unsigned int slice, const Range& rows, const Range& cols = Range::all());
 
 	// destination matrix is not required to be allocated
 	void contextOf(const Point3i& position, Mat& destination) const;
@@ -80,6 +92,9 @@ private:
 	Mat* buffer;
 	Point3i imagePosition, contextPosition;
 	bool border, croppedNeighborhood, useBuffer;
+	int precision;
+
+	Context& operator=(const Context&); // not assignable because of the buffer
 };
 
 class PositionNotSetException : public Exception {
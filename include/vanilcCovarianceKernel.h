@@ -0,0 +1,32 @@
+// Copyright (c) 2015 Siemens AG, Author: Andreas Weinlich
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <iostream>
+
+namespace vanilc {
+
+using namespace std;
+using namespace cv;
+
+const int GRAM_PADDING = 8; // vector length and matrix size of the single precision accumulation must be a multiple of this (pad with zeros)
+
+// adds weight * sampleVector' * sampleVector to the upper triangle (including the diagonal) of the n x n matrix covMat (step: row distance in elements);
+// each element is updated by exactly one multiplication of the sample with the weighted sample and one addition, so all instruction sets give identical results
+void accumulateWeightedOuterProduct(double* covMat, size_t step, const double* sampleVector, double weight, int n);
+
+// adds samples' * weightedSamples (count training vectors of length n in the rows of both matrices, sampleStep: row distance in elements) to the upper triangle of covMat;
+// cache-blocked over the training vectors and register-tiled over covMat, but each element sums up the products in the order of the training vectors just like
+// count calls of accumulateWeightedOuterProduct (bit-identical results); elements below the diagonal within the diagonal 4 x 4 blocks are overwritten as well
+void accumulateWeightedGramMatrix(double* covMat, size_t step, const double* samples, const double* weightedSamples, size_t sampleStep, int count, int n);
+
+// single precision version: n must be a multiple of GRAM_PADDING, so all tiles are complete (elements of the padding are computed but meaningless)
+void accumulateWeightedGramMatrix(float* covMat, size_t step, const float* samples, const float* weightedSamples, size_t sampleStep, int count, int n);
+
+} // end namespace vanilc
@@ -13,6 +13,7 @@
 
 #include "vanilcWeightingFunction.h"
 #include "vanilcStructuringElement.h"
+#include "vanilcBoundedHeap.h"
 
 namespace vanilc {
 
@@ -25,31 +26,31 @@ public:
 	CroppedPriorizedSSDWeightingFunction(const Mat& neighborhoodPriorization, unsigned int numWeights) :
 		neighborhoodPriorization(neighborhoodPriorization),
 		neighborhoodPriorizationPtr(neighborhoodPriorization.ptr<double>()),
-		bestDistances(1, numWeights, CV_64F, numeric_limits<double>::infinity()) {};
+		bestDistances(numWeights, numeric_limits<double>::infinity()) {};
 	CroppedPriorizedSSDWeightingFunction(const Point3i& referenceSpatialPoint, const Mat& neighborhoodPriorization, unsigned int numWeights) :
 		WeightingFunction(referenceSpatialPoint),
 		neighborhoodPriorization(neighborhoodPriorization),
 		neighborhoodPriorizationPtr(neighborhoodPriorization.ptr<double>()),
-		bestDistances(1, numWeights, CV_64F, numeric_limits<double>::infinity()) {};
+		bestDistances(numWeights, numeric_limits<double>::infinity()) {};
 	CroppedPriorizedSSDWeightingFunction(const Mat& referenceRegressionPoint, const Mat& neighborhoodPriorization, unsigned int numWeights) :
 		WeightingFunction(referenceRegressionPoint),
 		neighborhoodPriorization(neighborhoodPriorization),
 		neighborhoodPriorizationPtr(neighborhoodPriorization.ptr<double>()),
-		bestDistances(1, numWeights, CV_64F, numeric_limits<double>::infinity()) {};
+		bestDistances(numWeights, numeric_limits<double>::infinity()) {};
 	CroppedPriorizedSSDWeightingFunction(const Point3i& referenceSpatialPoint, const Mat& referenceRegressionPoint, const Mat& neighborhoodPriorization, unsigned int numWeights) :
 		WeightingFunction(referenceSpatialPoint, referenceRegressionPoint),
 		neighborhoodPriorization(neighborhoodPriorization),
 		neighborhoodPriorizationPtr(neighborhoodPriorization.ptr<double>()),
-		bestDistances(1, numWeights, CV_64F, numeric_limits<double>::infinity()) {};
+		bestDistances(numWeights, numeric_limits<double>::infinity()) {};
 
 	CroppedPriorizedSSDWeightingFunction* clone() const { return new CroppedPriorizedSSDWeightingFunction(*this); }; // "covariant return type" for "virtual copy constructor"
 
 	void setReferencePoint(const Mat& referenceRegressionPoint) {
-		bestDistances = Scalar(numeric_limits<double>::infinity());
+		bestDistances.reset(numeric_limits<double>::infinity());
 		WeightingFunction::setReferencePoint(referenceRegressionPoint);
 	};
 	void setReferencePoint(const Point3i& referenceSpatialPoint, const Mat& referenceRegressionPoint) {
-		bestDistances = Scalar(numeric_limits<double>::infinity());
+		bestDistances.reset(numeric_limits<double>::infinity());
 		WeightingFunction::setReferencePoint(referenceSpatialPoint, referenceRegressionPoint);
 	}
 
@@ -60,7 +61,7 @@ public:
 private:
 	const Mat neighborhoodPriorization;
 	const double* const neighborhoodPriorizationPtr;
-	Mat bestDistances;
+	BoundedHeap<double> bestDistances; // the numWeights smallest distances seen for the current reference point, the largest one on top
 };
 
 } // end namespace vanilc
@@ -0,0 +1,49 @@
+// Copyright (c) 2015 Siemens AG, Author: Andreas Weinlich
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <iostream>
+
+#include "vanilcLSPredictor.h"
+
+namespace vanilc {
+
+using namespace std;
+using namespace cv;
+
+// FASTLS with an exponentially decaying instead of a box-shaped training window: the training pixel at distance (dx, dy) is weighted with decay^(|dx| + dy).
+// The weighted sums of outer products are computed recursively (separable IIR filters): each completed row is filtered in both directions and added to
+// the decayed sums of all previous rows, the current row is filtered causally up to the current pixel. Only the current slice is used for training.
+class DecayLSPredictionComputer : public LSPredictionComputer {
+public:
+	DecayLSPredictionComputer(Mat* covMat, Mat* coefficients, Mat* weights, double border_regularization, double inner_regularization, int solver,
+		int reestimationInterval, double reestimationThreshold, double decay) :
+			LSPredictionComputer(covMat, coefficients, weights, IdentityWeightingFunction(), border_regularization, inner_regularization, 0, solver, 0, false,
+				reestimationInterval, reestimationThreshold, false), decay(decay) {};
+	void init();
+	bool isRecursive() const { return true; }; // sums of outer products are updated from pixel to pixel
+	int getNumberOfTrainingVectors() const; // sum of the weights of the decaying window
+
+private:
+	void estimate(const Point3i& currentPos);
+	void addRow(int row, int slice); // filter a completed row horizontally and add it to the vertically decayed sums
+	void outerProduct(const Point3i& position, double* outerProductPtr); // outer product of the neighborhood (and one for the sum of weights)
+
+	double decay;
+	Mat verticalSums; // per column: decayed sums of the two-sided filtered outer products of all completed rows
+	Mat outerProducts, horizontalSums; // rows of outer products and their causally filtered sums (only used in addRow)
+	Mat currentSum; // causally filtered outer products of the current row up to currentColumn
+	Mat sampleVector;
+	int sumSlice, sumRow; // last row that has been added to verticalSums
+	int currentRow, currentColumn;
+	double effectiveTrainingVectors; // -1 if the current pixel was estimated with the box-shaped training region (border pixels)
+};
+
+} // end namespace vanilc
@@ -38,6 +38,33 @@ const unsigned int OBSERVATION_UPDATE_INTERVAL = 64;
 // Order in which color channels are processed (e.g., { 0, 1, 2 } for BGR).
 const unsigned int CHANNEL_ORDER[] = { 1, 2, 0 };
 
+// For solver == SOLVER_CG: maximum number of conjugate gradient iterations and relative residual norm at which the warm-started solution is accepted
+// (otherwise the system is solved by the Cholesky decomposition). Encoder and decoder must use identical values.
+const int CG_MAX_ITERATIONS = 16;
+const double CG_TOLERANCE = 1e-6;
+
+// For patch_index: number of nearest neighbors whose quantized intensities form the key of a patch, number of quantization levels per neighbor,
+// and capacity of a bucket in multiples of max_training_vectors (a full bucket replaces its oldest patch). Encoder and decoder must use identical values.
+const int PATCH_INDEX_KEY_NEIGHBORS = 4;
+const int PATCH_INDEX_LEVELS = 8;
+const int PATCH_INDEX_BUCKET_FACTOR = 4;
+
+// -------------------- Exact Matching --------------------
+// For exact_match: lower bound of the variance of a prediction from an exactly matching neighborhood, and weight of the latest squared error in the
+// running mean of squared errors that estimates this variance. Encoder and decoder must use identical values.
+const double EXACT_MATCH_MIN_VARIANCE = 0.1;
+const double EXACT_MATCH_ADAPTATION = 1.0 / 16.0;
+
+// -------------------- Block LS --------------------
+// For the BLOCKLS predictor: the number of significant bits of the difference between a quantized coefficient and its prediction from the neighboring
+// blocks is coded with a Laplace distribution of this variance around a running mean with this weight. Encoder and decoder must use identical values.
+const double BLOCK_LS_BITS_VARIANCE = 2.0 * 2.0;
+const double BLOCK_LS_ADAPTATION = 1.0 / 8.0;
+
+// -------------------- Recursive LS --------------------
+// For the RLS predictor: smallest regularization (the initial inverse covariance matrix is the identity divided by the inner regularization).
+const double RLS_MIN_REGULARIZATION = 1e-3;
+
 // -------------------- Entropy Coding --------------------
 // Use Rice-Golomb entropy coding or arithmetic coding.
 //#define GOLOMB_CODING
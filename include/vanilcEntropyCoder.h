@@ -27,8 +27,12 @@ public:
 	EntropyCoder() : bitstream(bitqueue()), streamFront(8 * sizeof(STREAMTYPE) - 1), streamBack(0) {};
 	// reference used to avoid passing data through inheritance chain
 	EntropyCoder(const bitqueue& bitstream) : bitstream(bitstream), streamFront(8 * sizeof(STREAMTYPE) - 1), streamBack(0)  {};
-	void setBitstream(bitqueue bitstream) { this->bitstream = bitstream; };
+	void setBitstream(bitqueue bitstream) { this->bitstream = bitstream; resetReader(); };
 	bitqueue getBitstream() { return bitstream; };
+	unsigned int getBitstreamSize() const { return bitstream.size(); }; // number of STREAMTYPE elements
+	// substreams: append a finalized bitstream behind a finalized bitstream or remove it again from the end
+	void appendBitstream(const bitqueue& bitstream) { this->bitstream.insert(this->bitstream.end(), bitstream.begin(), bitstream.end()); };
+	bitqueue detachBitstream(unsigned int numberOfElements);
 	unsigned int readBitstream(ifstream& fs, int numberOfElements = -1); // return bytes read
 	unsigned int writeBitstream(ofstream& fs); // return bytes written
 	virtual void reset();
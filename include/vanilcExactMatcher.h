@@ -0,0 +1,45 @@
+// Copyright (c) 2015 Siemens AG, Author: Andreas Weinlich
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <iostream>
+#include <vector>
+
+#include "vanilcDefinitions.h"
+#include "vanilcContext.h"
+
+namespace vanilc {
+
+using namespace std;
+using namespace cv;
+
+// first prediction stage for synthetic content: keeps the last position of every causal neighborhood in a hash table; if the neighborhood
+// of the current pixel occurred before exactly, the pixel value at that position is the prediction (the configured predictor is skipped)
+class ExactMatcher {
+public:
+	ExactMatcher() : hit(false), previousHit(false) {};
+	void init(const Context& context); // empty table for the image of the context
+
+	bool match(const Point3i& currentPos, const Context& context); // looks up the neighborhood of the current pixel and inserts it afterwards
+	bool isHit() const { return hit; };
+	double getPrediction() const { return prediction; };
+	double getVariance() const { return max(EXACT_MATCH_MIN_VARIANCE, meanSquaredError); };
+
+private:
+	size_t hashOf(const Mat& neighbors) const;
+
+	vector<Point3i> table; // last position for each hash value (x < 0: empty)
+	size_t tableMask;
+	Mat sampleVector, candidateVector;
+	bool hit, previousHit;
+	double prediction, meanSquaredError; // running mean of the squared errors of matched predictions
+	Point3i previousPos;
+};
+
+} // end namespace vanilc
@@ -31,6 +31,7 @@ public:
 		previousPrediction = predictor->getPrediction();
 		return variance;
 	};
+	bool isRecursive() const { return true; };
 
 private:
 	double variance;
@@ -10,6 +10,7 @@
 
 #include <opencv2/opencv.hpp>
 #include <iostream>
+#include <vector>
 
 #include "vanilcLSPredictor.h"
 
@@ -20,20 +21,38 @@ using namespace cv;
 
 class FastLSPredictionComputer : public LSPredictionComputer {
 public:
-	FastLSPredictionComputer(Mat* covMat, Mat* coefficients, Mat* weights, double border_regularization, double inner_regularization, int solver) :
-		LSPredictionComputer(covMat, coefficients, weights, IdentityWeightingFunction(), border_regularization, inner_regularization, 0, solver, 0) {};
+	FastLSPredictionComputer(Mat* covMat, Mat* coefficients, Mat* weights, double border_regularization, double inner_regularization, int solver,
+		int reestimationInterval, double reestimationThreshold, bool exactIntegrals = false) :
+			LSPredictionComputer(covMat, coefficients, weights, IdentityWeightingFunction(), border_regularization, inner_regularization, 0, solver, 0, false,
+				reestimationInterval, reestimationThreshold, false), exactIntegrals(exactIntegrals) {};
 	void init();
+	bool isRecursive() const { return true; }; // ring buffer of covariance matrices is updated from pixel to pixel
 
 	// do only set the image when its memory has already been allocated! (otherwise the buffer is going to be empty, producing an error)
 	void setImage(Mat* image, unsigned int maxval);
 
 private:
-	void estimate(const Point3i& currentPos);
-	Mat getBuffer(const Point3i& currentPos);
+	// ringbuffer of integral rows over the whole image (outer products of the full neighborhood, zero outside of the image), row of zero integrals
+	template<typename T> struct Integrals { vector<T> buffer, zeroRow; };
 
-	Mat covMatBuffer;
-	Mat zeroBuffer; // covariance matrix with only zeros
-	unsigned int currentSlice, currentRow; // necessary for ringbuffer to save memory
+	void estimate(const Point3i& currentPos);
+	template<typename T> Integrals<T>& getIntegrals();
+	template<typename T> void sumIntegrals(const Point3i& currentPos, const vector<int>& elements); // box sum of the training region straight into covMat
+	template<typename T> void rotateBuffer(const Point3i& currentPos);
+	template<typename T> const T* getIntegral(const Point3i& currentPos);
+	template<typename T> void fillIntegrals(int slice, int row, int column); // fill all rows (and slices) the integral depends on, top down
+	template<typename T> void sweepRow(int slice, int row, int column); // extend the filled prefix of a single row
+	int entryOf(int slice, int row) const { return (slice % bufferSize[0]) * bufferSize[1] + row % bufferSize[1]; };
+
+	bool exactIntegrals; // integrals of integer pixel values in 64-bit integers (exact and independent of the fill order, half the memory)
+	Integrals<double> floatingIntegrals; // full matrices
+	Integrals<uint64> packedIntegrals; // packed upper triangles, wrap around on overflow: the box sums are exact nevertheless
+	int elementSize; // number of values per integral
+	vector<int> fullElements, croppedElements; // indices of the used neighborhood elements within the full neighborhood (cropped at image borders)
+	vector<int> filledColumns; // per buffered row: integrals are computed from left to right, so the filled positions of a row are a prefix
+	int bufferSize[3];
+	int currentSlice, currentRow; // necessary for ringbuffer to save memory
+	int firstSlice; // integrals of all previous slices are zero: box sums of the training region remain exact, the ringbuffer never wraps around
 };
 
 } // end namespace vanilc
@@ -10,8 +10,15 @@
 
 #include <opencv2/opencv.hpp>
 #include <iostream>
+#include <typeinfo>
 
+#include "vanilcDefinitions.h"
 #include "vanilcPredictor.h"
+#include "vanilcBoundedHeap.h"
+#include "vanilcCholesky.h"
+#include "vanilcConjugateGradient.h"
+#include "vanilcCovarianceKernel.h"
+#include "vanilcPatchIndex.h"
 #include "vanilcInversePriorizedSQDWeightingFunction.h"
 #include "vanilcInversePriorizedSSDWeightingFunction.h"
 #include "vanilcCroppedPriorizedSSDWeightingFunction.h"
@@ -22,23 +29,34 @@ namespace vanilc {
 using namespace std;
 using namespace cv;
 
+// solver option (in addition to OpenCV's DECOMP_XXX flags): conjugate gradient method, warm-started from the solution for the previous pixel
+const int SOLVER_CG = 5;
+
 class LSPredictionComputer : public Computer {
 public:
 	LSPredictionComputer(Mat* covMat, Mat* coefficients, Mat* weights, const WeightingFunction& weightingFunction,
-		double border_regularization, double inner_regularization, int wlsVarianceEquation, int solver, int maxTrainingVectors) :
+		double border_regularization, double inner_regularization, int wlsVarianceEquation, int solver, int maxTrainingVectors, bool batchedCovariance,
+		int reestimationInterval, double reestimationThreshold, bool patchIndex) :
 			covMat(covMat), coefficients(coefficients), weights(weights), weightingFunction(weightingFunction.clone()),
 			weightingContext(NULL), otherWeightingFunction(NULL),
 			border_regularization(border_regularization), inner_regularization(inner_regularization),
-			wlsVarianceEquation(wlsVarianceEquation), solver(solver), maxTrainingVectors(maxTrainingVectors) {};
+			wlsVarianceEquation(wlsVarianceEquation), solver(solver), maxTrainingVectors(maxTrainingVectors), batchedCovariance(batchedCovariance || patchIndex), singlePrecision(false),
+			reestimationInterval(reestimationInterval), reestimationThreshold(reestimationThreshold), reestimated(true),
+			patchIndex(patchIndex && maxTrainingVectors), nonLocalTraining(false) {};
 	LSPredictionComputer(Mat* covMat, Mat* coefficients, Mat* weights, const WeightingFunction& weightingFunction,
 		Context* weightingContext, const WeightingFunction& otherWeightingFunction,
-		double border_regularization, double inner_regularization, int wlsVarianceEquation, int solver, int maxTrainingVectors) :
+		double border_regularization, double inner_regularization, int wlsVarianceEquation, int solver, int maxTrainingVectors, bool batchedCovariance,
+		int reestimationInterval, double reestimationThreshold, bool patchIndex) :
 			covMat(covMat), coefficients(coefficients), weights(weights), weightingFunction(weightingFunction.clone()),
 			weightingContext(weightingContext), otherWeightingFunction(otherWeightingFunction.clone()),
 			border_regularization(border_regularization), inner_regularization(inner_regularization),
-			wlsVarianceEquation(wlsVarianceEquation), solver(solver), maxTrainingVectors(maxTrainingVectors) {};
+			wlsVarianceEquation(wlsVarianceEquation), solver(solver), maxTrainingVectors(maxTrainingVectors), batchedCovariance(batchedCovariance || patchIndex), singlePrecision(false),
+			reestimationInterval(reestimationInterval), reestimationThreshold(reestimationThreshold), reestimated(true),
+			patchIndex(patchIndex && maxTrainingVectors), nonLocalTraining(false) {};
 	~LSPredictionComputer() { delete covMat; delete coefficients; delete weights; delete weightingFunction; if(otherWeightingFunction) delete otherWeightingFunction; };
 	virtual void init() {
+		singlePrecision = (predictor->getContext().getPrecision() == CV_32F);
+		if(patchIndex) index.init(predictor->getContext().getFullNeighborhood(), predictor->getMaxval(), PATCH_INDEX_BUCKET_FACTOR * maxTrainingVectors);
 		weightingFunction->setMaxval(predictor->getMaxval());
 		if(weightingContext) {
 			otherWeightingFunction->setMaxval(predictor->getMaxval());
@@ -47,9 +65,19 @@ public:
 		}
 	};
 	double compute(const Point3i& currentPos, Context* context);
+	void advance(const Point3i& currentPos, Context* context);
+	bool isRecursive() const { return solver == SOLVER_CG || isLazy() || patchIndex; }; // the solution depends on the one of the previous pixel (or on all previous pixels)
+	bool isLazy() const { return reestimationInterval > 1; }; // coefficients are not estimated for every pixel
+	bool isReestimated() const { return reestimated; }; // false if the current prediction reused the coefficients of a previous pixel
+	bool sumOfSquaredTrainingResiduals(const Mat& residualCoefficients, double& sumOfSquaredResiduals);
+	virtual int getNumberOfTrainingVectors() const { return nonLocalTraining ? weights->cols : context->getTrainingregion().getNumberOfElements(); };
 
 protected:
 	virtual void estimate(const Point3i& currentPos);
+	void fetchCurrentSample(const Point3i& currentPos);
+	void setReferencePoint(const Point3i& currentPos); // of the weighting function (for the weighting context, its neighborhood is fetched here)
+	bool keepCoefficients(const Point3i& currentPos, int numberOfNeighbors);
+	bool isIndexed() const { return patchIndex && context->getNeighborhood().getNumberOfElements() == context->getFullNeighborhood().getNumberOfElements(); };
 	// state for current pixel
 	Context* context;
 	Context* weightingContext; // only for matching in order to compute weights (with otherWeightingFunction)
@@ -58,22 +86,73 @@ protected:
 	Mat* weights;
 
 private:
+	// training loop for a known class of weighting function: the weights are computed without virtual calls (and can be inlined)
+	template<class WF> void accumulateTrainingVectors(WF& weightingFunction, const Point3i& currentPos, Mat& sampleVector, double* weightsPtr);
+	// rank-1 update of covMat, or in batched mode and in single precision only gathering of the vector for one blocked accumulation after the training loop
+	void addTrainingVector(const Mat& sampleVector, double weight) {
+		if(singlePrecision) { // zero padding up to the row length for the single precision accumulation
+			const double* samplePtr = sampleVector.ptr<double>();
+			float* trainingVectorsPtr = trainingVectors.ptr<float>(numberOfTrainingVectors);
+			float* weightedTrainingVectorsPtr = weightedTrainingVectors.ptr<float>(numberOfTrainingVectors++);
+			const float singleWeight = (float)weight;
+			int l = 0;
+			for(; l < sampleVector.cols; ++l) weightedTrainingVectorsPtr[l] = (trainingVectorsPtr[l] = (float)samplePtr[l]) * singleWeight;
+			for(; l < trainingVectors.cols; ++l) weightedTrainingVectorsPtr[l] = trainingVectorsPtr[l] = 0.0f;
+		} else if(batchedCovariance) {
+			const double* samplePtr = sampleVector.ptr<double>();
+			double* trainingVectorsPtr = trainingVectors.ptr<double>(numberOfTrainingVectors);
+			double* weightedTrainingVectorsPtr = weightedTrainingVectors.ptr<double>(numberOfTrainingVectors++);
+			for(int l = 0; l < sampleVector.cols; ++l) weightedTrainingVectorsPtr[l] = (trainingVectorsPtr[l] = samplePtr[l]) * weight;
+		} else accumulateWeightedOuterProduct(covMat->ptr<double>(), covMat->step1(), sampleVector.ptr<double>(), weight, sampleVector.cols);
+	}
+
 	void solveSystem() {
-		if(!solve(covMat->colRange(0, covMat->rows), covMat->colRange(covMat->rows, covMat->cols), *coefficients, solver))
+		if(solver == SOLVER_CG && previousCoefficients.rows == covMat->rows) { // same system size as for the previous pixel: warm start
+			previousCoefficients.copyTo(*coefficients);
+			if(solveConjugateGradient(covMat->colRange(0, covMat->rows), covMat->colRange(covMat->rows, covMat->cols), *coefficients, CG_MAX_ITERATIONS, CG_TOLERANCE)) {
+				coefficients->copyTo(previousCoefficients);
+				return;
+			}
+		}
+		if(solver == DECOMP_CHOLESKY || solver == SOLVER_CG ? !solveCholesky(covMat->colRange(0, covMat->rows), covMat->colRange(covMat->rows, covMat->cols), *coefficients)
+			: !solve(covMat->colRange(0, covMat->rows), covMat->colRange(covMat->rows, covMat->cols), *coefficients, solver))
 			solve(covMat->colRange(0, covMat->rows), covMat->colRange(covMat->rows, covMat->cols), *coefficients, DECOMP_QR);
+		if(solver == SOLVER_CG) coefficients->copyTo(previousCoefficients);
 	}
 
 	WeightingFunction* weightingFunction;
 	WeightingFunction* otherWeightingFunction;
 	const double border_regularization, inner_regularization;
 	const int wlsVarianceEquation, solver, maxTrainingVectors;
+	const bool batchedCovariance;
+	bool singlePrecision; // accumulate covMat in single precision (solve in double precision)
+	Mat trainingVectors, weightedTrainingVectors; // gathered training vectors of the current pixel (unweighted and weighted, one per row) for batched mode
+	int numberOfTrainingVectors;
+	Mat singleCovMat;
+	Mat previousCoefficients; // for the warm start of SOLVER_CG
+	// private scratch rows for Context::contextOf (never shared, so their memory is reused) and copies of the reference points kept by the weighting functions
+	Mat currentSample, trainingSample, weightingSample, referenceSample, weightingReference;
+	// lazy LS: estimate and solve only every reestimationInterval pixels of a row, or earlier if the absolute residual of the previous pixel
+	// exceeds reestimationThreshold times the standard deviation of the training residuals (decoder sees the same residuals)
+	const int reestimationInterval;
+	const double reestimationThreshold;
+	bool reestimated;
+	Mat reusedCoefficients; // prediction coefficients of the last estimation as row vector (*coefficients may be modified by the variance computer)
+	int pixelsSinceEstimation;
+	Point3i estimationPos, previousPos;
+	double previousPrediction, residualDeviation;
+	// non-local training with max_training_vectors: the candidates of the training region are complemented by similar patches from the whole
+	// previously coded image (only for pixels whose neighborhood is not cropped at the border)
+	const bool patchIndex;
+	PatchIndex index;
+	bool nonLocalTraining; // current pixel was trained with candidates from the index (the weights then belong to the gathered training vectors)
 };
 
 
 class LSVarianceComputer : public Computer {
 public:
-	LSVarianceComputer(Mat* covMat, Mat* coefficients, Mat* weights, int wlsVarianceEquation) :
-		covMat(covMat), coefficients(coefficients), weights(weights), wlsVarianceEquation(wlsVarianceEquation) {};
+	LSVarianceComputer(Mat* covMat, Mat* coefficients, Mat* weights, int wlsVarianceEquation, LSPredictionComputer* predictionComputer = NULL) :
+		covMat(covMat), coefficients(coefficients), weights(weights), wlsVarianceEquation(wlsVarianceEquation), predictionComputer(predictionComputer) {};
 	double compute(const Point3i& currentPos, Context* context);
 
 protected:
@@ -83,16 +162,22 @@ protected:
 private:
 	Mat* weights;
 	const int wlsVarianceEquation;
+	LSPredictionComputer* predictionComputer; // provides the gathered training vectors and tells whether the coefficients of a previous pixel were reused (lazy LS)
+	double variance;
+	Mat sampleVector; // private scratch row for the second pass over the training region
 };
 
 
 class LSDegreesOfFreedomComputer : public Computer {
 public:
-	LSDegreesOfFreedomComputer(Mat* covMat) : covMat(covMat) {};
+	LSDegreesOfFreedomComputer(Mat* covMat, const LSPredictionComputer* predictionComputer = NULL) : covMat(covMat), predictionComputer(predictionComputer) {};
 	double compute(const Point3i& currentPos, Context* context);
 
 protected:
 	Mat* covMat;
+
+private:
+	const LSPredictionComputer* predictionComputer; // knows the number of training vectors for non-local training
 };
 
 } // end namespace vanilc
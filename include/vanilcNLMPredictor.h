@@ -10,6 +10,7 @@
 
 #include <opencv2/opencv.hpp>
 #include <iostream>
+#include <typeinfo>
 
 #include "vanilcPredictor.h"
 #include "vanilcExponentialSADWeightingFunction.h"
@@ -28,6 +29,9 @@ public:
 	double compute(const Point3i& currentPos, Context* context);
 
 private:
+	// weighted mean over the training region for a known class of weighting function (without virtual calls)
+	template<class WF> double weightedMean(WF& weightingFunction, const Point3i& currentPos, Context* context, Mat& sampleVector);
+
 	WeightingFunction* weightingFunction;
 };
 
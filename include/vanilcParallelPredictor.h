@@ -0,0 +1,63 @@
+// Copyright (c) 2015 Siemens AG, Author: Andreas Weinlich
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <iostream>
+#include <vector>
+
+#include "vanilcPredictor.h"
+
+// number of image rows each thread computes in one parallel step (more rows per step need more memory for intermediate results)
+const unsigned int PARALLEL_ROWS_PER_THREAD = 2;
+
+namespace vanilc {
+
+using namespace std;
+using namespace cv;
+
+// computes predictions, variances and degrees of freedom for whole blocks of rows with one predictor per thread;
+// each thread always processes the same part of a block, skipping the pixels of all other threads in between
+class ParallelPredictor : public ParallelLoopBody {
+public:
+	ParallelPredictor() : slice(0), results(NULL) {};
+	~ParallelPredictor() { clear(); };
+
+	// takes over memory management of predictor and weightingContext (which may be NULL); startPos is the first pixel the predictor sees
+	void addWorker(Predictor* predictor, Context* weightingContext, const Point3i& startPos);
+	void clear();
+	unsigned int getNumberOfWorkers() const { return workers.size(); };
+
+	// results must be allocated with at least rows.size() x width x 3 elements (prediction, variance, degrees of freedom)
+	void computeRows(unsigned int slice, const Range& rows, Mat& results);
+	void fillBuffer(Predictor& predictor, unsigned int slice, unsigned int height);
+	void operator()(const Range& range) const;
+
+private:
+	vector<Predictor*> workers;
+	vector<Context*> weightingContexts;
+	mutable vector<Point3i> nextPositions; // next pixel to be seen by each worker
+
+	// current job
+	unsigned int slice;
+	Range rows;
+	Mat* results;
+};
+
+class BufferFiller : public ParallelLoopBody {
+public:
+	BufferFiller(Predictor& predictor, unsigned int slice) : predictor(&predictor), slice(slice) {};
+	void operator()(const Range& range) const { predictor->fillBuffer(slice, range); };
+
+private:
+	Predictor* predictor;
+	unsigned int slice;
+};
+
+} // end namespace vanilc
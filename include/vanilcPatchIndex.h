@@ -0,0 +1,40 @@
+// Copyright (c) 2015 Siemens AG, Author: Andreas Weinlich
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <iostream>
+#include <vector>
+
+#include "vanilcStructuringElement.h"
+
+namespace vanilc {
+
+using namespace std;
+using namespace cv;
+
+// causal index of neighborhood patches for non-local training: the intensities of the nearest neighbors are coarsely quantized to a key,
+// positions with the same key are kept in a bucket of bounded size; a bucket is a (deterministic) candidate list of similar patches at constant cost
+class PatchIndex {
+public:
+	PatchIndex() : maxval(0), bucketSize(0) {};
+	void init(const StructuringElement& neighborhood, unsigned int maxval, int bucketSize); // empty index
+
+	int keyOf(const Mat& sampleVector) const; // neighbors of a position as row vector (further elements, e.g. the current pixel, are ignored)
+	void insert(int key, const Point3i& position);
+	const vector<Point3i>& getBucket(int key) const { return buckets[key]; };
+
+private:
+	vector<int> keyNeighbors; // indices of the nearest neighbors in the neighborhood vector
+	unsigned int maxval;
+	int bucketSize;
+	vector<vector<Point3i> > buckets;
+	vector<unsigned int> insertions; // number of positions ever inserted in each bucket (ring buffer position)
+};
+
+} // end namespace vanilc
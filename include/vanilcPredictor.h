@@ -13,6 +13,7 @@
 
 #include "vanilcContext.h"
 #include "vanilcComputer.h"
+#include "vanilcExactMatcher.h"
 
 namespace vanilc {
 
@@ -22,13 +23,14 @@ using namespace cv;
 class Predictor {
 public:
 	Predictor() :
-		predictionComputer(NULL), varianceComputer(NULL), degreesOfFreedomComputer(new Computer) {};
+		predictionComputer(NULL), varianceComputer(NULL), degreesOfFreedomComputer(new Computer), exactMatcher(NULL) {};
 	Predictor(const Context& context) :
-		predictionComputer(NULL), varianceComputer(NULL), degreesOfFreedomComputer(new Computer), context(context) {};
+		predictionComputer(NULL), varianceComputer(NULL), degreesOfFreedomComputer(new Computer), exactMatcher(NULL), context(context) {};
 	~Predictor() {
 		if(predictionComputer) delete predictionComputer;
 		if(varianceComputer) delete varianceComputer;
-		if(degreesOfFreedomComputer) delete degreesOfFreedomComputer; }
+		if(degreesOfFreedomComputer) delete degreesOfFreedomComputer;
+		if(exactMatcher) delete exactMatcher; }
 
 	void setPredictionComputer(Computer* predictionComputer) {
 		if(this->predictionComputer) delete(this->predictionComputer);
@@ -39,8 +41,12 @@ public:
 	void setDegreesOfFreedomComputer(Computer* degreesOfFreedomComputer) {
 		if(this->degreesOfFreedomComputer) delete(this->degreesOfFreedomComputer);
 		this->degreesOfFreedomComputer = degreesOfFreedomComputer; this->degreesOfFreedomComputer->setPredictor(this); };
+	void setExactMatcher(ExactMatcher* exactMatcher) { // first prediction stage (NULL: none)
+		if(this->exactMatcher) delete(this->exactMatcher);
+		this->exactMatcher = exactMatcher; };
 
 	const Context& getContext() const { return context; };
+	Computer* getPredictionComputer() { return predictionComputer; };
 	unsigned int getMaxval() const { return maxval; };
 	double getPrediction() const { return prediction; };
 
@@ -48,21 +54,45 @@ public:
 		context.setImage(image);
 		this->maxval = maxval;
 		if(buffered) context.bufferOn();
-		predictionComputer->init(); varianceComputer->init(); degreesOfFreedomComputer->init(); };
+		predictionComputer->init(); varianceComputer->init(); degreesOfFreedomComputer->init();
+		if(exactMatcher) exactMatcher->init(context); };
 
 	double computePrediction(const Point3i& currentPos) {
 		this->currentPos = currentPos;
 		context.checkBorder(currentPos); // in border regions shrink neighborhood and training region
+		if(exactMatcher && exactMatcher->match(currentPos, context)) { // neighborhood occurred before: skip the prediction computer
+			predictionComputer->advance(currentPos, &context);
+			return prediction = exactMatcher->getPrediction();
+		}
 		return prediction = predictionComputer->compute(currentPos, &context); };
 	double computeVariance() {
+		if(exactMatcher && exactMatcher->isHit()) {
+			if(varianceComputer->isRecursive()) varianceComputer->compute(currentPos, &context); // must see all predictions
+			return exactMatcher->getVariance();
+		}
 		return varianceComputer->compute(currentPos, &context); };
 	double computeDegreesOfFreedom() {
 		return degreesOfFreedomComputer->compute(currentPos, &context); };
 
+	// support for parallel coding with one predictor per thread
+	bool isRecursive() const { return predictionComputer->isRecursive() || degreesOfFreedomComputer->isRecursive() || exactMatcher != NULL; };
+	bool isVarianceRecursive() const { return varianceComputer->isRecursive(); };
+	void shareBuffer(const Predictor& predictor) { context.shareBuffer(predictor.context); };
+	void fillBuffer(unsigned int slice, const Range& rows, const Range& cols = Range::all()) { context.fillBuffer(slice, rows, cols); };
+	void skipPrediction(const Point3i& currentPos) { // only update the state of the prediction computer
+		this->currentPos = currentPos;
+		context.checkBorder(currentPos);
+		predictionComputer->advance(currentPos, &context); };
+	void setPrediction(const Point3i& currentPos, double prediction) { // prediction was computed by another predictor (allows computing a recursive variance afterwards)
+		this->currentPos = currentPos;
+		context.checkBorder(currentPos);
+		this->prediction = prediction; };
+
 private:
 	Computer* predictionComputer;
 	Computer* varianceComputer;
 	Computer* degreesOfFreedomComputer;
+	ExactMatcher* exactMatcher;
 
 	Context context;
 	unsigned int maxval;
@@ -16,7 +16,12 @@
 #include "vanilcMEDPredictor.h"
 #include "vanilcNLMPredictor.h"
 #include "vanilcFastLSPredictor.h"
+#include "vanilcDecayLSPredictor.h"
 #include "vanilcLSPredictor.h"
+#include "vanilcSlidingLSPredictor.h"
+#include "vanilcBlockLSPredictor.h"
+#include "vanilcRLSPredictor.h"
+#include "vanilcCascadePredictor.h"
 #include "vanilcExponentialVarianceComputer.h"
 #include "vanilcResidualVarianceComputer.h"
 
@@ -33,6 +38,9 @@ public:
 	static Predictor* constructFastLSpredictor(Config& config, const Context& context);
 	static Predictor* constructLSpredictor(Config& config, const Context& context);
 	static Predictor* constructWLSpredictor(Config& config, const Context& context, Context* weightingContext = NULL);
+	static Predictor* constructBlockLSpredictor(Config& config, const Context& context);
+	static Predictor* constructRLSpredictor(Config& config, const Context& context);
+	static Predictor* constructCascadepredictor(Config& config, const Context& context, Context* weightingContext = NULL);
 };
 
 } // end namespace vanilc
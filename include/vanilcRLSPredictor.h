@@ -0,0 +1,70 @@
+// Copyright (c) 2015 Siemens AG, Author: Andreas Weinlich
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <iostream>
+
+#include "vanilcDefinitions.h"
+#include "vanilcPredictor.h"
+
+namespace vanilc {
+
+using namespace std;
+using namespace cv;
+
+// recursive least-squares: the inverse of the exponentially weighted covariance matrix of all previous full neighborhoods along the scan is updated
+// with one rank-1 (Sherman-Morrison) step per pixel, which costs O(k^2) instead of solving a system of equations (pixels without full neighborhood use the neighborhood mean)
+class RLSPredictionComputer : public Computer {
+public:
+	RLSPredictionComputer(double forgettingFactor, double regularization) : forgettingFactor(forgettingFactor), regularization(max(regularization, RLS_MIN_REGULARIZATION)) {};
+	void init();
+	double compute(const Point3i& currentPos, Context* context);
+	bool isRecursive() const { return true; }; // coefficients are updated from pixel to pixel
+	void advance(const Point3i& currentPos, Context* context) { compute(currentPos, context); };
+
+	// analytical variance and degrees of freedom of the current prediction (as with LSVarianceComputer and LSDegreesOfFreedomComputer)
+	double getVariance() const;
+	int getDegreesOfFreedom() const;
+
+private:
+	void update(double value); // include the previous pixel into the estimate
+
+	double forgettingFactor, regularization;
+	int numberOfCoefficients;
+	Mat inverseCovariance; // P: inverse of the weighted covariance matrix of the neighborhoods (plus initial regularization)
+	Mat coefficients, sampleVector, gainVector; // gainVector = P x of the current neighborhood x
+	bool pending; // the current pixel was predicted with the coefficients and must be included into the estimate
+	Point3i currentPos;
+	double prediction, errorFactor; // errorFactor = x' P x
+	double sumOfSquaredResiduals, numberOfSamples; // exponentially weighted
+	double neighborhoodVariance; // for pixels without full neighborhood
+};
+
+class RLSVarianceComputer : public Computer {
+public:
+	RLSVarianceComputer(const RLSPredictionComputer* predictionComputer) : predictionComputer(predictionComputer) {};
+	double compute(const Point3i& currentPos, Context* context) { return predictionComputer->getVariance(); };
+	bool isRecursive() const { return true; };
+
+private:
+	const RLSPredictionComputer* predictionComputer;
+};
+
+class RLSDegreesOfFreedomComputer : public Computer {
+public:
+	RLSDegreesOfFreedomComputer(const RLSPredictionComputer* predictionComputer) : predictionComputer(predictionComputer) {};
+	double compute(const Point3i& currentPos, Context* context) { return predictionComputer->getDegreesOfFreedom(); };
+	bool isRecursive() const { return true; };
+
+private:
+	const RLSPredictionComputer* predictionComputer;
+};
+
+} // end namespace vanilc
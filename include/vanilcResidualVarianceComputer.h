@@ -20,7 +20,7 @@ class ResidualVarianceComputer : public Computer {
 public:
 	ResidualVarianceComputer(double radius) : estimationRegion(StructuringElement::createHalfEllipseElement(radius, radius, radius, false)) {};
 	ResidualVarianceComputer(StructuringElement str) : estimationRegion(str) {};
-	void init() { squaredResidualImage = predictor->getContext().getImage()->clone(); };
+	void init() { squaredResidualImage = predictor->getContext().getImage()->clone(); previousPrediction = 0.0; };
 
 	double compute(const Point3i& currentPos, Context* context) {
 		Point3i previousPos = currentPos;
@@ -36,6 +36,7 @@ public:
 //		else return predictor->getMaxval() * predictor->getMaxval() / 16.0;
 		return mean(sampleVector)[0];
 	};
+	bool isRecursive() const { return true; };
 
 private:
 	double previousPrediction;
@@ -0,0 +1,44 @@
+// Copyright (c) 2015 Siemens AG, Author: Andreas Weinlich
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <iostream>
+#include <vector>
+
+#include "vanilcLSPredictor.h"
+
+namespace vanilc {
+
+using namespace std;
+using namespace cv;
+
+// LS with a sliding covariance matrix: when moving one pixel to the right within a row, only the outer products of the training positions that enter the
+// training region are added and those of the positions that leave it are subtracted (for any shape of the training region). The sums are accumulated in
+// 64-bit integers: they are exact, do not drift, and do not depend on the path (pixels with cropped neighborhood or training region use the LS implementation).
+class SlidingLSPredictionComputer : public LSPredictionComputer {
+public:
+	SlidingLSPredictionComputer(Mat* covMat, Mat* coefficients, Mat* weights, double border_regularization, double inner_regularization, int wlsVarianceEquation,
+		int solver, bool batchedCovariance, int reestimationInterval, double reestimationThreshold) :
+			LSPredictionComputer(covMat, coefficients, weights, IdentityWeightingFunction(), border_regularization, inner_regularization, wlsVarianceEquation, solver, 0,
+				batchedCovariance, reestimationInterval, reestimationThreshold, false) {};
+	void init();
+
+private:
+	void estimate(const Point3i& currentPos);
+	void accumulate(const Point3i& position, int64 sign); // add (sign = 1) or subtract (sign = -1) the outer product of the neighborhood at position
+
+	vector<Point3i> trainingOffsets, enteringOffsets, leavingOffsets; // relative to the current pixel
+	vector<int64> sums; // upper triangle of the sum of outer products (including the current pixel of each training position)
+	Mat sampleVector;
+	Point3i sumPos; // position of the training region in sums
+	int maxSteps; // sliding over more pixels is slower than summing up the whole training region
+};
+
+} // end namespace vanilc
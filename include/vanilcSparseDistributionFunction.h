@@ -22,7 +22,9 @@ using namespace cv;
 
 class SparseDistributionFunction : public DistributionFunction {
 public:
-	SparseDistributionFunction(DistributionFunction* basicDist, Mat* image, unsigned int maxval, bool independentSlices, StructuringElement context, double strength) :
+	// firstPosition: first pixel to be coded with this distribution (substreams start without knowledge of previously coded pixels)
+	SparseDistributionFunction(DistributionFunction* basicDist, Mat* image, unsigned int maxval, bool independentSlices, StructuringElement context, double strength,
+		const Point3i& firstPosition = Point3i(0, 0, 0)) :
 		basicDist(basicDist),
 		image(image),
 		maxval(maxval),
@@ -37,7 +39,8 @@ public:
 		kernelRadius(maxval / 10 + 1),
 		smoothingKernel(getGaussianKernel(2 * kernelRadius + 1, (double)maxval / 20.0).reshape(0, 1)),
 		smallestNumberOfPixelsWithSameIntensityInPast(image->total()),
-		longtermTestarrayMean(0.0) {};
+		longtermTestarrayMean(0.0),
+		firstPosition(firstPosition) {};
 //			{ if(independentSlices) protectionMap = Mat(image->size[1], image->size[2], CV_8U, Scalar_<unsigned int>(0)); };
 	~SparseDistributionFunction() { delete basicDist; };
 
@@ -62,6 +65,7 @@ private:
 	Mat smoothingKernel;
 	int smallestNumberOfPixelsWithSameIntensityInPast;
 	double longtermTestarrayMean;
+	Point3i firstPosition;
 	vector<unsigned int> startsOfProbableValueRanges;
 	vector<unsigned int> endsOfProbableValueRanges;
 	vector<double> basicDistProbsAtStarts;
@@ -51,18 +51,27 @@ public:
 	unsigned int getBack() const { return (mask.dims == 3 ? mask.size[0] - anchor.z - 1 : 0); };
 	unsigned int getNumberOfElements() const { return numel; };
 	int increment(Point3i& position) const;
+	bool contains(const Point3i& offset) const { // offset relative to the anchor
+		const Point3i position = anchor + offset;
+		return position.z >= 0 && position.z < mask.size[0] && position.y >= 0 && position.y < mask.size[1] && position.x >= 0 && position.x < mask.size[2]
+			&& mask.at<uchar>(position.z, position.y, position.x) != _FLS_; };
 
 	Mat extractVectorFromPatch(const Mat& patch) const; // extracts values from patch according to mask; matrix sizes need to match!
 	void extractVectorFromPatch(const Mat& patch, double* destination) const; // efficient version; assumes that destination is already allocated!
 	Mat extractVectorFromImage(const Mat& image, const Point3i& position) const;
 	void extractVectorFromImage(const Mat& image, Point3i position, double* destination) const;
+	void extractVectorFromImage(const Mat& image, Point3i position, float* destination) const; // for single precision neighborhood buffers
 	void extractVectorFromImageBorderSafe(const Mat& image, const Point3i& position, Mat& destination);
+	void extractVectorFromImageZeroPadded(const Mat& image, const Point3i& position, double* destination) const; // all elements, zero outside of the image
 	void computeHistogramFromImageBorderSafe(const Mat& image, Point3i position, Mat& histogram); // (integer) histogram needs to be allocated before!
 
 protected:
 	Mat mask;
 	Point3i anchor;
 	unsigned int numel;
+
+private:
+	template<typename T> void extractVector(const Mat& image, Point3i position, T* destination) const;
 };
 
 } // end namespace vanilc
@@ -0,0 +1,91 @@
+// Copyright (c) 2015 Siemens AG, Author: Andreas Weinlich
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <iostream>
+#include <vector>
+
+#include "vanilcDefinitions.h"
+#include "vanilcPredictor.h"
+#ifdef ARITHMETIC_CODING
+	#include "vanilcDistributionMaker.h"
+	#include "vanilcArithmeticCoder.h"
+#endif
+#ifdef GOLOMB_CODING
+	#include "vanilcRiceGolombCoder.h"
+#endif
+
+// number of pixels of one image row that a substream codes in one parallel step (smaller segments let the following substream start earlier but need more synchronization)
+const unsigned int SUBSTREAM_SEGMENT_WIDTH = 32;
+
+namespace vanilc {
+
+using namespace std;
+using namespace cv;
+
+// consecutive image rows of one slice that are coded with an own predictor and entropy coder, segment by segment in raster order
+class Substream {
+public:
+	// takes over memory management of predictor and weightingContext (which may be NULL); sharedBuffer: predictor shares its neighborhood buffer with other threads
+	Substream(Predictor* predictor, Context* weightingContext, Mat* image, unsigned int slice, const Range& rows, bool sharedBuffer);
+	~Substream();
+
+	#ifdef ARITHMETIC_CODING
+		DistributionMaker& getDistributionMaker() { return distributionMaker; };
+		void setDistributionParameters(double regDistRatio, double regDistVar, bool sparse) { this->regDistRatio = regDistRatio; this->regDistVar = regDistVar; this->sparse = sparse; };
+		ArithmeticCoder& getEntropyCoder() { return entropyCoder; };
+	#elif defined GOLOMB_CODING
+		RiceGolombCoder& getEntropyCoder() { return entropyCoder; };
+	#endif
+	unsigned int getSlice() const { return slice; };
+	const Range& getRows() const { return rows; };
+	unsigned int getSegmentsPerRow() const { return (image->size[2] + SUBSTREAM_SEGMENT_WIDTH - 1) / SUBSTREAM_SEGMENT_WIDTH; };
+	unsigned int getNumberOfSegments() const { return rows.size() * getSegmentsPerRow(); };
+	// parallel step in which the first segment is coded
+	void setFirstStep(unsigned int firstStep) { this->firstStep = firstStep; };
+	unsigned int getFirstStep() const { return firstStep; };
+	unsigned int getEndStep() const { return firstStep + getNumberOfSegments(); };
+
+	void codeSegment(unsigned int segment, bool encoding);
+
+private:
+	Predictor* predictor;
+	Context* weightingContext;
+	Mat* image;
+	unsigned int slice;
+	Range rows;
+	bool sharedBuffer;
+	unsigned int firstStep;
+	#ifdef ARITHMETIC_CODING
+		DistributionMaker distributionMaker;
+		double regDistRatio, regDistVar;
+		bool sparse;
+		ArithmeticCoder entropyCoder;
+	#elif defined GOLOMB_CODING
+		RiceGolombCoder entropyCoder;
+	#endif
+
+	Substream(const Substream&); // not copyable because of the distribution maker that is referenced by the entropy coder
+	Substream& operator=(const Substream&);
+};
+
+// codes the current segment of all given substreams in parallel
+class ParallelSubstreamCoder : public ParallelLoopBody {
+public:
+	ParallelSubstreamCoder(const vector<Substream*>& substreams, unsigned int step, bool encoding) : substreams(&substreams), step(step), encoding(encoding) {};
+	void operator()(const Range& range) const;
+
+private:
+	const vector<Substream*>* substreams;
+	unsigned int step;
+	bool encoding;
+};
+
+} // end namespace vanilc
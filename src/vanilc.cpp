@@ -18,6 +18,7 @@
 #include "vanilcPredictor.h"
 #include "vanilcTimer.h"
 #include "vanilcRawIO.h"
+#include "vanilcBatchCoder.h"
 
 using namespace cv;
 using namespace vanilc;
@@ -37,6 +38,11 @@ int main(int argc, char* argv[]) {
 		cout << endl;
 	#endif
 
+	if(config.get<string>("batch") != "") { // many files with the same configuration
+		BatchCoder batchCoder(config);
+		return batchCoder.run() ? EXIT_FAILURE : EXIT_SUCCESS;
+	}
+
 	Mat image;
 
 	if(config.get<string>("input") != "") { // load image
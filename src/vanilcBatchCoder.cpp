@@ -0,0 +1,119 @@
+// Copyright (c) 2015 Siemens AG, Author: Andreas Weinlich
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+#include "vanilcBatchCoder.h"
+
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+
+#include "vanilcCoder.h"
+#include "vanilcTimer.h"
+#include "vanilcRawIO.h"
+
+namespace vanilc {
+
+// encodes the files given by config "batch" into the directory "bitstream" or decodes them into the directory "output"
+BatchCoder::BatchCoder(Config& config) : config(&config), failed(0) {
+	encoding = (config.get<string>("bitstream") != "");
+	verbose = !config.get<bool>("quiet");
+	const string destinationDirectory = (encoding ? config.get<string>("bitstream") : config.get<string>("output"));
+	vector<string> files;
+	collectFiles(config.get<string>("batch"), files);
+	for(unsigned int i = 0; i < files.size(); ++i) {
+		Job job;
+		job.source = files[i];
+		string filename = getFilename(files[i]);
+		if(encoding) filename += ".vanilc";
+		else if(filename.size() > 7 && filename.compare(filename.size() - 7, 7, ".vanilc") == 0)
+			filename.erase(filename.size() - 7); // the remaining extension determines the image format
+		job.destination = destinationDirectory + "/" + filename;
+		ifstream fs(files[i].c_str(), ios::binary | ios::ate);
+		job.cost = (double)fs.tellg();
+		fs.close();
+		jobs.push_back(job);
+	}
+	stable_sort(jobs.begin(), jobs.end());
+} // end BatchCoder::BatchCoder
+
+// source is a directory, a pattern with wildcards (* or ?), or a manifest file with one filename per line
+void BatchCoder::collectFiles(const string& source, vector<string>& files) const {
+	ifstream manifest;
+	if(source.find_first_of("*?") == string::npos) manifest.open(source.c_str());
+	if(manifest.is_open() && manifest.peek() != EOF) { // directories cannot be read as a file
+		string line;
+		while(getline(manifest, line)) {
+			if(!line.empty() && line[line.size() - 1] == '\r') line.erase(line.size() - 1); // manifest written on Windows
+			if(!line.empty() && line[0] != '#') files.push_back(line);
+		}
+	} else glob(source, files);
+} // end BatchCoder::collectFiles
+
+string BatchCoder::getFilename(const string& path) {
+	const size_t separator = path.find_last_of("/\\");
+	return (separator == string::npos ? path : path.substr(separator + 1));
+} // end BatchCoder::getFilename
+
+unsigned int BatchCoder::run() {
+	if(verbose) cout << (encoding ? "Encoding " : "Decoding ") << jobs.size() << " files with " << (config->get<int>("threads") ? config->get<int>("threads") : getNumberOfCPUs()) << " threads." << endl;
+	Timer timer;
+	if(config->get<int>("threads")) setNumThreads(config->get<int>("threads"));
+	config->set("threads", 1); // one file per thread: coding the files themselves in parallel would only add synchronization
+	config->set("quiet", true); // no progress output of the individual coders
+	parallel_for_(Range(0, jobs.size()), ParallelBatchCoder(*this), jobs.size()); // free threads take the next job in the list
+	if(verbose) cout << "Batch finished: " << jobs.size() - failed << " of " << jobs.size() << " files coded in " << timer.getREALtime() << "s." << endl;
+	return failed;
+} // end BatchCoder::run
+
+// one summary line per file: bits per pixel and coding time
+void BatchCoder::codeJob(const Job& job) {
+	Timer timer;
+	ostringstream summary;
+	try {
+		Mat image;
+		unsigned int filesize;
+		if(encoding) {
+			if(config->get<string>("dimensions") == "")
+				image = imread(job.source, CV_LOAD_IMAGE_ANYDEPTH | CV_LOAD_IMAGE_ANYCOLOR);
+			else {
+				RawIO rawReader;
+				image = rawReader.imread(job.source, config->get<string>("dimensions"));
+			}
+			if(!image.data) throw Exception(CV_StsError, "It was not possible to read the image.", "BatchCoder::codeJob", __FILE__, __LINE__);
+			Coder coder(*config);
+			coder.setImage(image);
+			coder.code(1);
+			filesize = coder.writeBitstreamToFile(job.destination);
+		} else {
+			Coder coder(*config);
+			filesize = coder.readBitstreamFromFile(job.source);
+			coder.code(0);
+			coder.getImage(image);
+			if(image.dims == 3) {
+				RawIO rawWriter;
+				rawWriter.imwrite(job.destination, image);
+			} else if(!imwrite(job.destination, image))
+				throw Exception(CV_StsError, "It was not possible to write the image.", "BatchCoder::codeJob", __FILE__, __LINE__);
+		}
+		summary << job.source << " -> " << job.destination << ": " << (double)filesize * 8.0 / (double)image.total() / (double)image.channels() << " bpp, " << timer.getREALtime() << "s";
+	} catch(exception& e) {
+		summary << job.source << ": failed (" << e.what() << ")";
+		AutoLock lock(outputMutex);
+		++failed;
+		cerr << summary.str() << endl;
+		return;
+	}
+	AutoLock lock(outputMutex);
+	if(verbose) cout << summary.str() << endl;
+} // end BatchCoder::codeJob
+
+void ParallelBatchCoder::operator()(const Range& range) const {
+	for(int i = range.start; i < range.end; ++i)
+		batchCoder->codeJob(batchCoder->jobs[i]);
+} // end ParallelBatchCoder::operator()
+
+} // end namespace vanilc
@@ -0,0 +1,100 @@
+// Copyright (c) 2015 Siemens AG, Author: Andreas Weinlich
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "vanilcBlockLSPredictor.h"
+
+namespace vanilc {
+
+double BlockLSPredictionComputer::compute(const Point3i& currentPos, Context* context) {
+	context->contextOf(currentPos, sampleVector);
+	const int numberOfNeighbors = sampleVector.cols - 1;
+	const double* samplePtr = sampleVector.ptr<double>();
+	if(numberOfNeighbors == blockCoefficients.cols) { // full neighborhood: linear prediction with the coefficients of the block
+		const double* coefficientPtr = blockCoefficients.ptr<double>(currentPos.y / blockSize * blocksPerRow + currentPos.x / blockSize);
+		double prediction = 0.0;
+		for(int i = 0; i < numberOfNeighbors; ++i) prediction += coefficientPtr[i] * samplePtr[i];
+		return (prediction < 0.0 ? 0.0 : (prediction > predictor->getMaxval() ? predictor->getMaxval() : prediction)); // crop to valid value range
+	}
+	if(numberOfNeighbors) // border pixel
+		return mean(sampleVector.colRange(0, numberOfNeighbors))[0];
+	else return (1.0 + predictor->getMaxval()) / 2.0; // first pixel of image
+} // end BlockLSPredictionComputer::compute
+
+void BlockLSPredictionComputer::resetCoefficients(const Context& context) {
+	const Mat& image = *context.getImage();
+	height = image.size[1];
+	width = image.size[2];
+	blocksPerRow = (width + blockSize - 1) / blockSize;
+	quantizedCoefficients = Mat::zeros(blocksPerRow * ((height + blockSize - 1) / blockSize), context.getFullNeighborhood().getNumberOfElements() - 1, CV_32S);
+	updateCoefficients();
+} // end BlockLSPredictionComputer::resetCoefficients
+
+// the best linear predictor of a block is estimated from the pixels of the block itself that have a full neighborhood (those that are predicted with it)
+void BlockLSPredictionComputer::estimateCoefficients(unsigned int slice, const Context& context) {
+	resetCoefficients(context);
+	const Mat& image = *context.getImage();
+	const int numberOfCoefficients = quantizedCoefficients.cols;
+	const double scale = (double)(1 << coefficientBits), maxCoefficient = (double)(1 << 29); // the difference to the prediction must fit into an int
+	Context blockContext(context); // without buffer
+	Mat covMat(numberOfCoefficients, numberOfCoefficients + 1, CV_64F), solution;
+	for(int block = 0; block < quantizedCoefficients.rows; ++block) {
+		const int top = block / blocksPerRow * blockSize, left = block % blocksPerRow * blockSize;
+		covMat = Scalar(0.0);
+		int numberOfSamples = 0;
+		for(int y = top; y < min(top + blockSize, image.size[1]); ++y)
+			for(int x = left; x < min(left + blockSize, image.size[2]); ++x) {
+				const Point3i position(x, y, slice);
+				blockContext.checkBorder(position);
+				if((int)blockContext.getNeighborhood().getNumberOfElements() != numberOfCoefficients + 1) continue; // predicted with the neighborhood mean
+				blockContext.contextOf(position, sampleVector);
+				const double* samplePtr = sampleVector.ptr<double>();
+				for(int i = 0; i < numberOfCoefficients; ++i) { // upper triangle of X'X and right hand side X'y (the current pixel is the last sample)
+					double* covPtr = covMat.ptr<double>(i);
+					for(int j = i; j <= numberOfCoefficients; ++j) covPtr[j] += samplePtr[i] * samplePtr[j];
+				}
+				++numberOfSamples;
+			}
+		int* quantizedPtr = quantizedCoefficients.ptr<int>(block);
+		if(numberOfSamples < numberOfCoefficients) { // (almost) no pixel of the block uses the coefficients: choose the cheapest ones
+			for(int i = 0; i < numberOfCoefficients; ++i) quantizedPtr[i] = predictCoefficient(block, i);
+			continue;
+		}
+		for(int i = 0; i < numberOfCoefficients; ++i) {
+			covMat.at<double>(i, i) += regularization;
+			for(int j = 0; j < i; ++j) covMat.at<double>(i, j) = covMat.at<double>(j, i);
+		}
+		if(!solve(covMat.colRange(0, numberOfCoefficients), covMat.col(numberOfCoefficients), solution, solver == DECOMP_QR ? DECOMP_QR : DECOMP_CHOLESKY))
+			solve(covMat.colRange(0, numberOfCoefficients), covMat.col(numberOfCoefficients), solution, DECOMP_SVD);
+		for(int i = 0; i < numberOfCoefficients; ++i) {
+			const double coefficient = solution.at<double>(i) * scale;
+			quantizedPtr[i] = cvRound(coefficient < -maxCoefficient ? -maxCoefficient : (coefficient > maxCoefficient ? maxCoefficient : coefficient));
+		}
+	}
+	updateCoefficients();
+} // end BlockLSPredictionComputer::estimateCoefficients
+
+// neighboring blocks have similar coefficients: mean of the left and the upper block (zero for the first block)
+int BlockLSPredictionComputer::predictCoefficient(int block, int i) const {
+	const bool left = (block % blocksPerRow > 0), top = (block >= blocksPerRow);
+	if(left && top) return cvFloor(0.5 * ((double)quantizedCoefficients.at<int>(block - 1, i) + (double)quantizedCoefficients.at<int>(block - blocksPerRow, i)));
+	else if(left) return quantizedCoefficients.at<int>(block - 1, i);
+	else if(top) return quantizedCoefficients.at<int>(block - blocksPerRow, i);
+	else return 0;
+} // end BlockLSPredictionComputer::predictCoefficient
+
+int BlockLSPredictionComputer::getDegreesOfFreedom(const Point3i& currentPos) const {
+	const int top = currentPos.y / blockSize * blockSize, left = currentPos.x / blockSize * blockSize;
+	const int dof = (min(top + blockSize, height) - top) * (min(left + blockSize, width) - left) - blockCoefficients.cols;
+	return (dof < 1 ? 1 : dof);
+} // end BlockLSPredictionComputer::getDegreesOfFreedom
+
+void BlockLSPredictionComputer::updateCoefficients() {
+	quantizedCoefficients.convertTo(blockCoefficients, CV_64F, 1.0 / (double)(1 << coefficientBits));
+} // end BlockLSPredictionComputer::updateCoefficients
+
+} // end namespace vanilc
@@ -0,0 +1,75 @@
+// Copyright (c) 2015 Siemens AG, Author: Andreas Weinlich
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "vanilcCascadePredictor.h"
+
+namespace vanilc {
+
+CascadePredictionComputer::CascadePredictionComputer(Predictor* flatPredictor, Predictor* moderatePredictor, Predictor* texturePredictor,
+	double flatThreshold, double textureThreshold) : flatThreshold(flatThreshold), textureThreshold(textureThreshold), currentStage(-1), buffersShared(false) {
+	stages[STAGE_FLAT] = flatPredictor; stages[STAGE_MODERATE] = moderatePredictor; stages[STAGE_TEXTURE] = texturePredictor;
+} // end CascadePredictionComputer::CascadePredictionComputer
+
+CascadePredictionComputer::~CascadePredictionComputer() {
+	for(int s = 0; s < NUMBER_OF_STAGES; ++s) delete stages[s];
+} // end CascadePredictionComputer::~CascadePredictionComputer
+
+void CascadePredictionComputer::init() {
+	const Context& context = predictor->getContext();
+	for(int s = 0; s < NUMBER_OF_STAGES; ++s) // the stages work on the same image but have their own neighborhood buffers (unless they share the one of the cascade)
+		stages[s]->setImage(const_cast<Mat*>(context.getImage()), predictor->getMaxval(), false);
+	activityScale = 256.0 / (1.0 + predictor->getMaxval());
+	currentStage = -1;
+	buffersShared = false; // the buffer of the cascade predictor may be switched on or shared after init
+} // end CascadePredictionComputer::init
+
+bool CascadePredictionComputer::isRecursive() const {
+	for(int s = 0; s < NUMBER_OF_STAGES; ++s)
+		if(stages[s]->isRecursive()) return true;
+	return false;
+} // end CascadePredictionComputer::isRecursive
+
+double CascadePredictionComputer::compute(const Point3i& currentPos, Context* context) {
+	if(!buffersShared && context->getBuffered()) {
+		stages[STAGE_MODERATE]->shareBuffer(*predictor); stages[STAGE_TEXTURE]->shareBuffer(*predictor);
+		buffersShared = true;
+	}
+	const double activity = computeActivity(currentPos, context);
+	currentStage = (activity <= flatThreshold ? STAGE_FLAT : (activity <= textureThreshold ? STAGE_MODERATE : STAGE_TEXTURE));
+	skipStages(currentPos, currentStage);
+	return stages[currentStage]->computePrediction(currentPos);
+} // end CascadePredictionComputer::compute
+
+void CascadePredictionComputer::advance(const Point3i& currentPos, Context* context) {
+	currentStage = -1;
+	skipStages(currentPos, currentStage);
+} // end CascadePredictionComputer::advance
+
+// standard deviation of the causal neighborhood (without the current pixel) in 8-bit units: zero if there are less than two neighbors
+double CascadePredictionComputer::computeActivity(const Point3i& currentPos, Context* context) {
+	context->contextOf(currentPos, sampleVector);
+	const int numberOfNeighbors = sampleVector.cols - 1;
+	if(numberOfNeighbors < 2) return 0.0;
+	const double* samplePtr = sampleVector.ptr<double>();
+	double sum = 0.0, sumOfSquares = 0.0;
+	for(int i = 0; i < numberOfNeighbors; ++i) { sum += samplePtr[i]; sumOfSquares += samplePtr[i] * samplePtr[i]; }
+	const double variance = (sumOfSquares - sum * sum / numberOfNeighbors) / numberOfNeighbors;
+	return (variance > 0.0 ? sqrt(variance) * activityScale : 0.0);
+} // end CascadePredictionComputer::computeActivity
+
+void CascadePredictionComputer::skipStages(const Point3i& currentPos, int chosenStage) {
+	for(int s = 0; s < NUMBER_OF_STAGES; ++s)
+		if(s != chosenStage && stages[s]->isRecursive()) stages[s]->skipPrediction(currentPos);
+} // end CascadePredictionComputer::skipStages
+
+double CascadeVarianceComputer::compute(const Point3i& currentPos, Context* context) {
+	const double fallbackVariance = fallbackComputer.compute(currentPos, context); // must see all predictions
+	return (predictionComputer->isLeastSquaresStage() ? predictionComputer->getCurrentStage()->computeVariance() : fallbackVariance);
+} // end CascadeVarianceComputer::compute
+
+} // end namespace vanilc
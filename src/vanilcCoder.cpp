@@ -14,6 +14,7 @@ Coder::Coder(Config& config) : config(&config), imageDirection(0), predictor(NUL
 	// config
 	verbose = !config.get<bool>("quiet");
 	sparsify_distribution = config.get<double>("sparsify_distribution");
+	threads = (config.get<int>("threads") ? config.get<int>("threads") : getNumberOfCPUs());
 
 	// configure context
 	if(config.get<double>("neighborhood_front") > 0) // 3-D neighborhood prediction?
@@ -30,6 +31,8 @@ Coder::Coder(Config& config) : config(&config), imageDirection(0), predictor(NUL
 		else weightingContext.setFullNeighborhood(StructuringElement::createHalfEllipseElement(config.get<double>("other_matching_neighborhood"), config.get<double>("other_matching_neighborhood"), config.get<double>("other_matching_neighborhood"), true)); // configure 2-D neighborhood mask
 		weightingContext.setFullTrainingregion(context.getTrainingregion());
 	}
+	context.setPrecision(config.get<string>("precision") == "FLOAT" ? CV_32F : CV_64F); // the decoder reads it from the bitstream header
+	weightingContext.setPrecision(context.getPrecision());
 
 	createPredictor();
 
@@ -57,22 +60,275 @@ Coder::~Coder() {
 
 void Coder::createPredictor() {
 	if(predictor) { delete predictor; predictor = NULL; }
+	parallelPredictor.clear(); // workers depend on the predictor
+	predictor = constructPredictor(&weightingContext);
+} // end Coder::definePredictor
+
+Predictor* Coder::constructPredictor(Context* weightingContext) {
+	Predictor* newPredictor;
 	if(config->get<string>("predictor") == "MEAN")
-		predictor = PredictorConstructor::constructMeanpredictor(*config, context);
+		newPredictor = PredictorConstructor::constructMeanpredictor(*config, context);
 	else if(config->get<string>("predictor") == "MED")
-		predictor = PredictorConstructor::constructMEDpredictor(*config, context);
+		newPredictor = PredictorConstructor::constructMEDpredictor(*config, context);
 	else if(config->get<string>("predictor") == "NLM")
-		predictor = PredictorConstructor::constructNLMpredictor(*config, context);
+		newPredictor = PredictorConstructor::constructNLMpredictor(*config, context);
 	else if(config->get<string>("predictor") == "FASTLS")
-		predictor = PredictorConstructor::constructFastLSpredictor(*config, context);
+		newPredictor = PredictorConstructor::constructFastLSpredictor(*config, context);
 	else if(config->get<string>("predictor") == "LS")
-		predictor = PredictorConstructor::constructLSpredictor(*config, context);
+		newPredictor = PredictorConstructor::constructLSpredictor(*config, context);
+	else if(config->get<string>("predictor") == "BLOCKLS")
+		newPredictor = PredictorConstructor::constructBlockLSpredictor(*config, context);
+	else if(config->get<string>("predictor") == "RLS")
+		newPredictor = PredictorConstructor::constructRLSpredictor(*config, context);
+	else if(config->get<string>("predictor") == "CASCADE")
+		newPredictor = PredictorConstructor::constructCascadepredictor(*config, context, config->get<double>("other_matching_neighborhood") > 0.0 ? weightingContext : NULL);
 	else
 		// configure covariance matrix estimator with weighting function and contexts for training and prediction
 		if(config->get<double>("other_matching_neighborhood") > 0.0)
-			predictor = PredictorConstructor::constructWLSpredictor(*config, context, &weightingContext);
-		else predictor = PredictorConstructor::constructWLSpredictor(*config, context);
-} // end Coder::definePredictor
+			newPredictor = PredictorConstructor::constructWLSpredictor(*config, context, weightingContext);
+		else newPredictor = PredictorConstructor::constructWLSpredictor(*config, context);
+	if(config->get<bool>("exact_match")) newPredictor->setExactMatcher(new ExactMatcher);
+	return newPredictor;
+} // end Coder::constructPredictor
+
+// one predictor per thread for parallel encoding: each one starts with the same state as the main predictor at the first pixel of slice
+void Coder::createWorkers(unsigned int slice, unsigned int maxval) {
+	parallelPredictor.clear();
+	if(threads < 2 || predictor->isRecursive()) return; // predictions depend on previous predictions -> no parallelization possible
+	for(unsigned int t = 0; t < threads; ++t) {
+		Context* workerWeightingContext;
+		Predictor* worker = createWorker(maxval, workerWeightingContext);
+		if(worker->isVarianceRecursive()) worker->setVarianceComputer(new Computer); // computed by main predictor in raster order
+		parallelPredictor.addWorker(worker, workerWeightingContext, Point3i(0, 0, slice));
+	}
+} // end Coder::createWorkers
+
+// additional predictor for another thread that works on the same image and shares the neighborhood buffer of the main predictor (or has its own one)
+Predictor* Coder::createWorker(unsigned int maxval, Context*& workerWeightingContext, bool ownBuffer) {
+	workerWeightingContext = (config->get<double>("other_matching_neighborhood") > 0.0 ? new Context(weightingContext) : NULL);
+	Predictor* worker = constructPredictor(workerWeightingContext);
+	worker->setImage(&image, maxval, ownBuffer && config->get<bool>("neighborhood_buffer"));
+	if(!ownBuffer) worker->shareBuffer(*predictor);
+	return worker;
+} // end Coder::createWorker
+
+#ifdef ARITHMETIC_CODING
+// choose a parametric distribution for pixel intensities (firstPosition: first pixel to be coded with this distribution)
+void Coder::createDistribution(DistributionMaker& distributionMaker, unsigned int maxval, const Point3i& firstPosition) {
+	DistributionFunction* mainDistributionFunction;
+	if(config->get<string>("distribution") == "T")
+		mainDistributionFunction = new TDistributionFunction();
+	else if(config->get<string>("distribution") == "LAPLACE")
+		mainDistributionFunction = new LaplaceDistributionFunction();
+	else if(config->get<string>("distribution") == "UNIFORM")
+		mainDistributionFunction = new UniformDistributionFunction();
+	else
+		mainDistributionFunction = new NormalDistributionFunction();
+	if(sparsify_distribution > 0.0) distributionMaker.addDistributionFunction(
+		new SparseDistributionFunction(mainDistributionFunction, &image, maxval, type == img_color ,
+			StructuringElement::createHalfCircleElement(config->get<double>("sparsification_size"), false), sparsify_distribution, firstPosition));
+	else distributionMaker.addDistributionFunction(mainDistributionFunction);
+	if(config->get<string>("regularization_distribution") == "UNIFORM") {
+		distributionMaker.addDistributionFunction(new UniformDistributionFunction());
+		regDistVar = 1.0;
+		regDistRatio = ((double)maxval + 1.0) / (double)(1 << config->get<int>("max_bits_per_pixel") - 1); // needs further examination why " - 1" is necessary
+	} else if(config->get<string>("regularization_distribution") == "LAPLACE") {
+		distributionMaker.addDistributionFunction(new LaplaceDistributionFunction());
+		regDistVar = pow((double)maxval / log(config->get<double>("max_to_min_regularization_ratio")), 2.0) * 2.0;
+		regDistRatio = config->get<double>("max_to_min_regularization_ratio") * sqrt(regDistVar * 2.0) / (double)(1 << config->get<int>("max_bits_per_pixel"))
+			* (1.0 - exp(-((double)maxval + 1.0) / sqrt(2.0 * regDistVar))); // upper bound
+	} else {
+		distributionMaker.addDistributionFunction(new NormalDistributionFunction());
+		regDistVar = ((double)maxval * (double)maxval) / (2.0 * log(config->get<double>("max_to_min_regularization_ratio")));
+		regDistRatio = config->get<double>("max_to_min_regularization_ratio") * sqrt(regDistVar * 2.0 * M_PI) / (double)(1 << config->get<int>("max_bits_per_pixel"))
+			#ifdef BOOST
+				* boost::math::erf(((double)maxval + 1.0) / sqrt(8.0 * regDistVar)); // upper bound (version with dependency on boost)
+			#elif defined WIN32
+				; // this case is only to satisfy the compiler but it should never happen
+			#else
+				* erf(((double)maxval + 1.0) / sqrt(8.0 * regDistVar)); // upper bound (version with dependency on GCC)
+			#endif
+	}
+} // end Coder::createDistribution
+#endif
+
+Substream* Coder::createSubstream(unsigned int slice, const Range& rows, unsigned int maxval, bool ownBuffer) {
+	Context* workerWeightingContext;
+	Predictor* worker = createWorker(maxval, workerWeightingContext, ownBuffer);
+	Substream* substream = new Substream(worker, workerWeightingContext, &image, slice, rows, !ownBuffer);
+	#ifdef ARITHMETIC_CODING
+		createDistribution(substream->getDistributionMaker(), maxval, Point3i(0, rows.start, slice));
+		substream->setDistributionParameters(regDistRatio, regDistVar, sparsify_distribution > 0.0);
+	#endif
+	return substream;
+} // end Coder::createSubstream
+
+// substream sizes (in STREAMTYPE elements): number of significant bits relative to the previous size, followed by the remaining bits
+void Coder::codeSubstreamSizes(vector<unsigned int>& sizes, bool encoding) {
+	const unsigned int maxBits = 8 * sizeof(unsigned int);
+	#ifdef ARITHMETIC_CODING
+		DistributionMaker sizeBitsDistribution(maxBits + 2);
+		sizeBitsDistribution.addDistributionFunction(new LaplaceDistributionFunction());
+		DistributionMaker bitDistribution(3);
+		bitDistribution.addDistributionFunction(new UniformDistributionFunction());
+		bitDistribution.getDistributionFunction()->setParameters((Mat_<double>(1, 1) << 1.0), 1);
+	#endif
+	unsigned int previousBits = 8;
+	for(unsigned int i = 0; i < sizes.size(); ++i) {
+		unsigned int bits = 0;
+		if(encoding) while(bits < maxBits && sizes[i] >> bits) ++bits;
+		#ifdef ARITHMETIC_CODING
+			sizeBitsDistribution.getDistributionFunction()->setParameters((Mat_<double>(3, 1) << 1.0, (double)previousBits, 4.0 * 4.0), maxBits);
+			entropyCoder->setDistribution(sizeBitsDistribution.getImplicitDistribution());
+		#elif defined GOLOMB_CODING
+			entropyCoder->setParameters((double)previousBits, 4.0 * 4.0);
+		#endif
+		entropyCoder->code(bits, encoding);
+		#ifdef ARITHMETIC_CODING
+			entropyCoder->setDistribution(bitDistribution.getImplicitDistribution());
+		#elif defined GOLOMB_CODING
+			entropyCoder->setParameters(.5, 1);
+		#endif
+		if(!encoding) sizes[i] = (bits ? 1 : 0);
+		for(int b = (int)bits - 2; b >= 0; --b) { // the most significant bit is always one
+			unsigned int bit = (sizes[i] >> b) & 1;
+			entropyCoder->code(bit, encoding);
+			if(!encoding) sizes[i] = (sizes[i] << 1) | bit;
+		}
+		previousBits = bits;
+	}
+} // end Coder::codeSubstreamSizes
+
+// code the image in substreams that can be processed in parallel: the main bitstream contains the sizes of all substreams that follow it
+void Coder::codeSubstreams(bool encoding, unsigned int maxval, unsigned int width, unsigned int height, unsigned int depth) {
+	vector<EntropyCoder::bitqueue> bitstreams;
+	if(config->get<string>("substreams") == "TILES")
+		bitstreams.resize(((height + config->get<int>("tile_height") - 1) / config->get<int>("tile_height")) * ((width + config->get<int>("tile_width") - 1) / config->get<int>("tile_width")));
+	else if(config->get<string>("substreams") == "CHANNELS")
+		bitstreams.resize(depth - (type == img_color ? 1 : 0));
+	else bitstreams.resize((depth - (type == img_color ? 1 : 0)) * ((height + config->get<int>("substream_rows") - 1) / config->get<int>("substream_rows")));
+	vector<unsigned int> sizes(bitstreams.size());
+	if(!encoding) {
+		codeSubstreamSizes(sizes, false);
+		unsigned int totalSize = 0;
+		for(unsigned int i = 0; i < sizes.size(); ++i) totalSize += sizes[i];
+		EntropyCoder::bitqueue substreamBitstreams = entropyCoder->detachBitstream(totalSize);
+		EntropyCoder::bitqueue::iterator it = substreamBitstreams.begin();
+		for(unsigned int i = 0; i < sizes.size(); ++i, it += sizes[i - 1])
+			bitstreams[i].assign(it, it + sizes[i]);
+	}
+	if(verbose) cout << "progress (%): [";
+	if(config->get<string>("substreams") == "TILES") codeTiles(encoding, maxval, bitstreams);
+	else codeSubstreamSteps(encoding, maxval, width, height, depth, bitstreams);
+	if(verbose) cout << "100] ";
+	if(encoding) {
+		for(unsigned int i = 0; i < sizes.size(); ++i) sizes[i] = bitstreams[i].size();
+		codeSubstreamSizes(sizes, true);
+		entropyCoder->finalize();
+		for(unsigned int i = 0; i < bitstreams.size(); ++i) entropyCoder->appendBitstream(bitstreams[i]);
+	}
+} // end Coder::codeSubstreams
+
+// wavefront and channel substreams run in parallel steps: in each step, every active substream codes one segment of its current row;
+// each substream starts as soon as the previous one is far enough ahead to provide all pixels needed for coding its first segment
+void Coder::codeSubstreamSteps(bool encoding, unsigned int maxval, unsigned int width, unsigned int height, unsigned int depth, vector<EntropyCoder::bitqueue>& bitstreams) {
+	const bool channels = (config->get<string>("substreams") == "CHANNELS"); // one substream per color channel or slice, otherwise groups of rows
+	const bool ownBuffer = (channels && type == img_color && config->get<int>("inter_channel_prediction")); // the neighborhood differs from channel to channel
+	const unsigned int firstSlice = (type == img_color ? 1 : 0);
+	const unsigned int rowsPerSubstream = (channels ? height : config->get<int>("substream_rows"));
+	const unsigned int substreamsPerSlice = (height + rowsPerSubstream - 1) / rowsPerSubstream;
+
+	// horizontal reach of all pixels that are required to code one pixel: the following substream must lag behind by at least this number of pixels
+	unsigned int reach = context.getRight();
+	if(config->get<double>("other_matching_neighborhood") > 0.0) reach = max(reach, weightingContext.getRight());
+	if(sparsify_distribution > 0.0) reach = max(reach, StructuringElement::createHalfCircleElement(config->get<double>("sparsification_size"), false).getRight());
+	const unsigned int segmentsPerRow = (width + SUBSTREAM_SEGMENT_WIDTH - 1) / SUBSTREAM_SEGMENT_WIDTH;
+	const unsigned int lag = (reach + SUBSTREAM_SEGMENT_WIDTH - 1) / SUBSTREAM_SEGMENT_WIDTH + 1;
+
+	// substreams are created when their first step is reached and deleted when they are complete
+	vector<Substream*> activeSubstreams;
+	unsigned int nextSubstream = 0, nextFirstStep = 0, percentage = 1;
+	for(unsigned int step = 0; nextSubstream < bitstreams.size() || !activeSubstreams.empty(); ++step) {
+		if(nextSubstream < bitstreams.size() && step == nextFirstStep) {
+			const unsigned int j = firstSlice + nextSubstream / substreamsPerSlice, k = nextSubstream % substreamsPerSlice * rowsPerSubstream;
+			if(config->get<int>("inter_channel_prediction") && type == img_color && j > 1 && !k) { // include previous color channels into prediction neighborhood (affine prediction)
+				if(config->get<int>("inter_channel_prediction") == 1)
+					context.setFullNeighborhood(StructuringElement::createHalfEllipseElementMultichannel(
+						config->get<double>("neighborhood_top"), config->get<double>("neighborhood_left"), config->get<double>("neighborhood_right"), j, true));
+				else	context.setFullNeighborhood(StructuringElement::createHalfEllipseElementMultichannelForward(
+						config->get<double>("neighborhood_top"), config->get<double>("neighborhood_left"), config->get<double>("neighborhood_right"), j, true));
+				if(!channels) { // all previous substreams are complete: the main predictor can be replaced
+					createPredictor();
+					predictor->setImage(&image, maxval, config->get<bool>("neighborhood_buffer"));
+				}
+			}
+			Substream* substream = createSubstream(j, Range(k, min(k + rowsPerSubstream, height)), maxval, ownBuffer);
+			if(!encoding) substream->getEntropyCoder().setBitstream(bitstreams[nextSubstream]);
+			substream->setFirstStep(step);
+			if(++nextSubstream % substreamsPerSlice) // the first row of the next substream needs the last row of this one up to the reach
+				nextFirstStep = step + (substream->getRows().size() - 1) * segmentsPerRow + lag;
+			else if(channels) // the next channel or slice needs the rows of this one up to the bottom of the context
+				nextFirstStep = step + context.getBottom() * segmentsPerRow + lag;
+			else nextFirstStep = substream->getEndStep(); // wavefront: start a new slice when the previous one is complete
+			activeSubstreams.push_back(substream);
+		}
+		parallel_for_(Range(0, activeSubstreams.size()), ParallelSubstreamCoder(activeSubstreams, step, encoding), threads);
+		while(!activeSubstreams.empty() && activeSubstreams.front()->getEndStep() == step + 1) { // substreams are completed in the order of creation
+			Substream* substream = activeSubstreams.front();
+			const unsigned int completedRows = (substream->getSlice() - firstSlice) * height + substream->getRows().end;
+			if(encoding) {
+				substream->getEntropyCoder().finalize();
+				bitstreams[(substream->getSlice() - firstSlice) * substreamsPerSlice + substream->getRows().start / rowsPerSubstream] = substream->getEntropyCoder().getBitstream();
+			}
+			for(; verbose && percentage < 100 && percentage * (depth - firstSlice) * height <= 100 * completedRows; ++percentage)
+				cout << percentage << " ";
+			delete substream;
+			activeSubstreams.erase(activeSubstreams.begin());
+		}
+	}
+} // end Coder::codeSubstreamSteps
+
+// tiles are coded as independent images (with all slices) in raster order of tiles
+void Coder::codeTiles(bool encoding, unsigned int maxval, vector<EntropyCoder::bitqueue>& bitstreams) {
+	parallel_for_(Range(0, bitstreams.size()), ParallelTileCoder(*this, encoding, maxval, bitstreams), threads);
+} // end Coder::codeTiles
+
+// only the tile is kept in memory (including the neighborhood buffer of its predictor)
+void Coder::codeTile(unsigned int tile, bool encoding, unsigned int maxval, EntropyCoder::bitqueue& bitstream) {
+	const int tileWidth = config->get<int>("tile_width"), tileHeight = config->get<int>("tile_height");
+	const int tilesPerRow = (image.size[2] + tileWidth - 1) / tileWidth;
+	Range r[] = { Range::all(), Range(tile / tilesPerRow * tileHeight, min((int)(tile / tilesPerRow + 1) * tileHeight, image.size[1])),
+		Range(tile % tilesPerRow * tileWidth, min((int)(tile % tilesPerRow + 1) * tileWidth, image.size[2])) };
+	Coder tileCoder(*config);
+	if(tileCoder.context.getPrecision() != context.getPrecision()) { // the decoder takes the precision from the header, not from the config
+		tileCoder.context.setPrecision(context.getPrecision());
+		tileCoder.weightingContext.setPrecision(context.getPrecision());
+		tileCoder.createPredictor();
+	}
+	tileCoder.verbose = false;
+	tileCoder.threads = 1;
+	tileCoder.type = type;
+	tileCoder.bitdepth = bitdepth;
+	if(encoding) tileCoder.image = image(r).clone();
+	else {
+		int sz[] = { image.size[0], r[1].size(), r[2].size() };
+		tileCoder.image = Mat(3, sz, CV_64F, numeric_limits<double>::quiet_NaN());
+		if(type == img_color) {
+			Range r0[] = { Range(0, 1), Range::all(), Range::all() };
+			tileCoder.image(r0) = Scalar(1.0);
+		}
+		tileCoder.entropyCoder->setBitstream(bitstream);
+	}
+	tileCoder.predictor->setImage(&(tileCoder.image), maxval, config->get<bool>("neighborhood_buffer"));
+	tileCoder.codePixels(encoding, maxval, r[2].size(), r[1].size(), image.size[0]);
+	if(encoding) bitstream = tileCoder.entropyCoder->getBitstream();
+	else tileCoder.image.copyTo(image(r));
+} // end Coder::codeTile
+
+void ParallelTileCoder::operator()(const Range& range) const {
+	for(int t = range.start; t < range.end; ++t)
+		coder->codeTile(t, encoding, maxval, (*bitstreams)[t]);
+} // end ParallelTileCoder::operator()
 
 void Coder::convertTo2D(const Mat& image3D, Mat& image2D, unsigned int slice) const {
 	image2D.create(image3D.size[1], image3D.size[2], CV_64F);
@@ -150,7 +406,7 @@ void Coder::setImage(const Mat& image) {
 			this->image = transp(this->image);
 		}
 	}
-	predictor->setImage(&(this->image), ((1 << bitdepth) - 1), config->get<bool>("neighborhood_buffer"));
+	predictor->setImage(&(this->image), ((1 << bitdepth) - 1), config->get<bool>("neighborhood_buffer") && config->get<string>("substreams") != "TILES"); // tiles have their own buffers
 } // end Coder::setImage
 
 // restore original image type
@@ -228,7 +484,18 @@ void Coder::codeHeader(bool encoding, unsigned int &maxval, unsigned int &width,
 	#elif defined GOLOMB_CODING
 		entropyCoder->setParameters(8.0, 4.0 * 4.0);
 	#endif
+	// a leading zero (no valid bitdepth) signals single precision arithmetic, so double precision bitstreams keep their format
+	unsigned int singlePrecision = (context.getPrecision() == CV_32F);
+	if(encoding && singlePrecision) { unsigned int marker = 0; entropyCoder->code(marker, true); }
 	entropyCoder->code(bitdepth, encoding);
+	if(!encoding) {
+		if((singlePrecision = !bitdepth)) entropyCoder->code(bitdepth, false);
+		if(singlePrecision != (context.getPrecision() == CV_32F)) { // bitstream was coded with the other precision
+			context.setPrecision(singlePrecision ? CV_32F : CV_64F);
+			weightingContext.setPrecision(context.getPrecision());
+			createPredictor();
+		}
+	}
 	maxval = ((1 << bitdepth) - 1); // maximum intensity value in image
 	// header: image dimensions (width, height, possibly depth)
 	#ifdef ARITHMETIC_CODING
@@ -275,62 +542,33 @@ void Coder::codeHeader(bool encoding, unsigned int &maxval, unsigned int &width,
 			Range r[] = { Range(0, 1), Range::all(), Range::all() };
 			image(r) = Scalar(1.0);
 		}
-		predictor->setImage(&image, maxval, config->get<bool>("neighborhood_buffer"));
+		predictor->setImage(&image, maxval, config->get<bool>("neighborhood_buffer") && config->get<string>("substreams") != "TILES"); // tiles have their own buffers
 	}
 } // end Coder::codeHeader
 
 void Coder::code(char encoding) {
-	double prediction, variance, dof;
 	unsigned int maxval, width, height, depth = 1;
 	codeHeader((bool)encoding, maxval, width, height, depth);
+	if(encoding < 2 && config->get<string>("substreams") != "NONE") codeSubstreams((bool)encoding, maxval, width, height, depth); // parallel substreams
+	else codePixels(encoding, maxval, width, height, depth);
+} // end Coder::code
+
+// code all pixels of the image in raster order into the main bitstream
+void Coder::codePixels(char encoding, unsigned int maxval, unsigned int width, unsigned int height, unsigned int depth) {
+	double prediction, variance, dof;
 
-	// choose a parametric distribution for pixel intensities
 	#ifdef OBSERVEENCODING
 		namedWindow("Prediction observation window", CV_WINDOW_NORMAL);
 		Mat residualImage;
 	#endif
 	#ifdef ARITHMETIC_CODING
 		DistributionMaker distributionMaker(maxval + 2);
-		DistributionFunction* mainDistributionFunction;
-		double regDistVar, regDistRatio;
-	if(encoding < 2) { // not only prediction
-		if(config->get<string>("distribution") == "T")
-			mainDistributionFunction = new TDistributionFunction();
-		else if(config->get<string>("distribution") == "LAPLACE")
-			mainDistributionFunction = new LaplaceDistributionFunction();
-		else if(config->get<string>("distribution") == "UNIFORM")
-			mainDistributionFunction = new UniformDistributionFunction();
-		else
-			mainDistributionFunction = new NormalDistributionFunction();
-		if(sparsify_distribution > 0.0) distributionMaker.addDistributionFunction(
-			new SparseDistributionFunction(mainDistributionFunction, &image, maxval, type == img_color ,
-				StructuringElement::createHalfCircleElement(config->get<double>("sparsification_size"), false), sparsify_distribution));
-		else distributionMaker.addDistributionFunction(mainDistributionFunction);
-		if(config->get<string>("regularization_distribution") == "UNIFORM") {
-			distributionMaker.addDistributionFunction(new UniformDistributionFunction());
-			regDistVar = 1.0;
-			regDistRatio = ((double)maxval + 1.0) / (double)(1 << config->get<int>("max_bits_per_pixel") - 1); // needs further examination why " - 1" is necessary
-		} else if(config->get<string>("regularization_distribution") == "LAPLACE") {
-			distributionMaker.addDistributionFunction(new LaplaceDistributionFunction());
-			regDistVar = pow((double)maxval / log(config->get<double>("max_to_min_regularization_ratio")), 2.0) * 2.0;
-			regDistRatio = config->get<double>("max_to_min_regularization_ratio") * sqrt(regDistVar * 2.0) / (double)(1 << config->get<int>("max_bits_per_pixel"))
-				* (1.0 - exp(-((double)maxval + 1.0) / sqrt(2.0 * regDistVar))); // upper bound
-		} else {
-			distributionMaker.addDistributionFunction(new NormalDistributionFunction());
-			regDistVar = ((double)maxval * (double)maxval) / (2.0 * log(config->get<double>("max_to_min_regularization_ratio")));
-			regDistRatio = config->get<double>("max_to_min_regularization_ratio") * sqrt(regDistVar * 2.0 * M_PI) / (double)(1 << config->get<int>("max_bits_per_pixel"))
-				#ifdef BOOST
-					* boost::math::erf(((double)maxval + 1.0) / sqrt(8.0 * regDistVar)); // upper bound (version with dependency on boost)
-				#elif defined WIN32
-					; // this case is only to satisfy the compiler but it should never happen
-				#else
-					* erf(((double)maxval + 1.0) / sqrt(8.0 * regDistVar)); // upper bound (version with dependency on GCC)
-				#endif
-		}
-		entropyCoder->setDistribution(distributionMaker.getImplicitDistribution());
-	#else
-	if(encoding < 2) { // not only prediction
 	#endif
+	if(encoding < 2) { // not only prediction
+		#ifdef ARITHMETIC_CODING
+			createDistribution(distributionMaker, maxval);
+			entropyCoder->setDistribution(distributionMaker.getImplicitDistribution());
+		#endif
 	} else { // only prediction
 		predictionImage.create(3, image.size, CV_64F);
 		varianceImage.create(3, image.size, CV_64F);
@@ -342,6 +580,14 @@ void Coder::code(char encoding) {
 		if(verbose) cout << "progress (%): [";
 	#endif
 
+	// the encoder knows all pixels in advance: compute predictions for blocks of rows in parallel and code them afterwards in raster order
+	if(encoding) createWorkers(type == img_color ? 1 : 0, maxval);
+	Mat parallelResults;
+	if(parallelPredictor.getNumberOfWorkers()) {
+		int sz[] = { (int)(parallelPredictor.getNumberOfWorkers() * PARALLEL_ROWS_PER_THREAD), (int)width, 3 };
+		parallelResults.create(3, sz, CV_64F);
+	}
+
 	// main processing loop for pixel-wise coding
 	for(int j = (type == img_color ? 1 : 0); j < (int)depth; ++j) {
 		#ifdef DEBUGOUT
@@ -363,7 +609,16 @@ void Coder::code(char encoding) {
 					config->get<double>("neighborhood_top"), config->get<double>("neighborhood_left"), config->get<double>("neighborhood_right"), j, true));
 			createPredictor();
 			predictor->setImage(&image, maxval, config->get<bool>("neighborhood_buffer"));
+			if(encoding) createWorkers(j, maxval);
 		}
+		if(config->get<string>("predictor") == "BLOCKLS") { // the coefficients of all blocks of the slice precede its pixels
+			codeBlockCoefficients(j, encoding);
+			#ifdef ARITHMETIC_CODING
+				if(encoding < 2) entropyCoder->setDistribution(distributionMaker.getImplicitDistribution());
+			#endif
+		}
+		if(parallelPredictor.getNumberOfWorkers()) parallelPredictor.fillBuffer(*predictor, j, height);
+		int parallelRowsStart = 0, parallelRowsEnd = 0;
 		for(int k = 0, kk = 0, percentage = (100 * (type == img_color ? j - 1 : j) - 1) / (int)(type == img_color ? depth - 1 : depth) + 1;
 			percentage <= (100 * (type == img_color ? j : j + 1) - 1) / (int)(type == img_color ? depth - 1 : depth) + 1; ++percentage) {
 		kk = (type == img_color ? depth - 1 : depth) * height * percentage / 100 - (type == img_color ? j - 1 : j) * height;
@@ -372,10 +627,25 @@ void Coder::code(char encoding) {
 			#ifdef DEBUGOUT
 				cout << k << " ";
 			#endif
+			if(parallelPredictor.getNumberOfWorkers() && k >= parallelRowsEnd) {
+				parallelRowsStart = k;
+				parallelRowsEnd = min(k + parallelResults.size[0], (int)height);
+				parallelPredictor.computeRows(j, Range(parallelRowsStart, parallelRowsEnd), parallelResults);
+			}
 			for(int l = 0; l < (int)width; ++l) {
-				prediction = predictor->computePrediction(Point3i(l, k, j));
-				variance = predictor->computeVariance();
-				dof = predictor->computeDegreesOfFreedom();
+				if(parallelPredictor.getNumberOfWorkers()) {
+					const double* parallelResultsPtr = &(parallelResults.at<double>(k - parallelRowsStart, l, 0));
+					prediction = parallelResultsPtr[0];
+					if(predictor->isVarianceRecursive()) { // variance depends on all previous predictions
+						predictor->setPrediction(Point3i(l, k, j), prediction);
+						variance = predictor->computeVariance();
+					} else variance = parallelResultsPtr[1];
+					dof = parallelResultsPtr[2];
+				} else {
+					prediction = predictor->computePrediction(Point3i(l, k, j));
+					variance = predictor->computeVariance();
+					dof = predictor->computeDegreesOfFreedom();
+				}
 				if(encoding < 2) { // not only prediction
 					#ifdef ARITHMETIC_CODING
 						if(sparsify_distribution > 0) distributionMaker.getDistributionFunction(0)->setParameters(
@@ -441,7 +711,62 @@ void Coder::code(char encoding) {
 			while(pressedKey != config->get<int>("keycode_q") && pressedKey != config->get<int>("keycode_esc")) pressedKey = waitKey();
 		}
 	#endif
-} // end Coder::code
+} // end Coder::codePixels
+
+// forward-adaptive BLOCKLS predictor: the encoder estimates the coefficients of all blocks of a slice; each quantized coefficient is coded as difference
+// to its prediction from the neighboring blocks: number of significant bits (relative to the recent ones of this coefficient), sign, and the remaining bits
+void Coder::codeBlockCoefficients(unsigned int slice, char encoding) {
+	BlockLSPredictionComputer* blockComputer = static_cast<BlockLSPredictionComputer*>(predictor->getPredictionComputer());
+	if(encoding) blockComputer->estimateCoefficients(slice, predictor->getContext());
+	else blockComputer->resetCoefficients(predictor->getContext());
+	if(encoding == 2) return; // prediction only
+	Mat& coefficients = blockComputer->getQuantizedCoefficients();
+	const unsigned int maxBits = 8 * sizeof(int) - 1;
+	#ifdef ARITHMETIC_CODING
+		DistributionMaker differenceBitsDistribution(maxBits + 2);
+		differenceBitsDistribution.addDistributionFunction(new LaplaceDistributionFunction());
+		DistributionMaker bitDistribution(3); // equiprobable bits: symmetric distribution around 0.5 cropped to the two symbols
+		bitDistribution.addDistributionFunction(new LaplaceDistributionFunction());
+		bitDistribution.getDistributionFunction()->setParameters((Mat_<double>(3, 1) << 1.0, 0.5, 1.0), 1);
+	#endif
+	vector<double> meanBits(coefficients.cols, (double)blockComputer->getCoefficientBits() / 2.0);
+	for(int block = 0; block < coefficients.rows; ++block)
+		for(int i = 0; i < coefficients.cols; ++i) {
+			const int prediction = blockComputer->predictCoefficient(block, i);
+			unsigned int difference = 0, bits = 0, sign = 0;
+			if(encoding) {
+				sign = (coefficients.at<int>(block, i) < prediction);
+				difference = (sign ? prediction - coefficients.at<int>(block, i) : coefficients.at<int>(block, i) - prediction);
+				while(bits < maxBits && difference >> bits) ++bits;
+			}
+			#ifdef ARITHMETIC_CODING
+				differenceBitsDistribution.getDistributionFunction()->setParameters((Mat_<double>(3, 1) << 1.0, meanBits[i], BLOCK_LS_BITS_VARIANCE), maxBits);
+				entropyCoder->setDistribution(differenceBitsDistribution.getImplicitDistribution());
+			#elif defined GOLOMB_CODING
+				entropyCoder->setParameters(meanBits[i], BLOCK_LS_BITS_VARIANCE);
+			#endif
+			entropyCoder->code(bits, (bool)encoding);
+			meanBits[i] = (1.0 - BLOCK_LS_ADAPTATION) * meanBits[i] + BLOCK_LS_ADAPTATION * (double)bits;
+			if(!bits) {
+				coefficients.at<int>(block, i) = prediction;
+				continue;
+			}
+			#ifdef ARITHMETIC_CODING
+				entropyCoder->setDistribution(bitDistribution.getImplicitDistribution());
+			#elif defined GOLOMB_CODING
+				entropyCoder->setParameters(.5, 1);
+			#endif
+			entropyCoder->code(sign, (bool)encoding);
+			if(!encoding) difference = 1;
+			for(int b = (int)bits - 2; b >= 0; --b) { // the most significant bit is always one
+				unsigned int bit = (difference >> b) & 1;
+				entropyCoder->code(bit, (bool)encoding);
+				if(!encoding) difference = (difference << 1) | bit;
+			}
+			coefficients.at<int>(block, i) = (sign ? prediction - (int)difference : prediction + (int)difference);
+		}
+	if(!encoding) blockComputer->updateCoefficients();
+} // end Coder::codeBlockCoefficients
 
 } // end namespace vanilc
 
@@ -31,6 +31,8 @@ Config::Config() {
 		"Binary file where encoded bitstream is written to or from which bitstream for decoding is read}")));
 	parameters.insert(pair<string, GenericParameter*>("dimensions", new Parameter<string>("", 'd',
 		"Image dimensions (size) for reading RAW 3-D images given in format BITDEPTHxWIDTHxHEIGHTxDEPTH, e.g., 8x512x512x10}")));
+	parameters.insert(pair<string, GenericParameter*>("batch", new Parameter<string>("", 0,
+		"Batch mode: directory, pattern with wildcards (e.g., /path/*.pgm), or manifest file (one filename per line) of images to be encoded into the directory given by -b or of bitstreams to be decoded into the directory given by -o; the files are distributed over the threads")));
 	parameters.insert(pair<string, GenericParameter*>("quiet", new Parameter<bool>(false, 'q',
 		"Do not show any command line output")));
 } // end Config::Config
@@ -46,7 +48,7 @@ void Config::insertMoreParameters() {
 	parameters.insert(pair<string, GenericParameter*>("keycode_esc", new Parameter<int>(1048603, 0,
 		"Keycode for ESC key to close window.")));
 	parameters.insert(pair<string, GenericParameter*>("predictor", new Parameter<string>("WLS", 0,
-		"For least-squares, choose between efficient 'WLS' encoder (default), 'LS' (without weighting), and faster 'FASTLS' predictor. Other predictors contain 'NLM' (non-local means), 'MED' (LOCO-I median predictor), and 'MEAN' (average of neighborhood pixels) predictors.")));
+		"For least-squares, choose between efficient 'WLS' encoder (default), 'LS' (without weighting), faster 'FASTLS' predictor, 'BLOCKLS' (coefficients estimated per block by the encoder and transmitted: fast decoding), 'RLS' (recursive least-squares: coefficients updated from pixel to pixel along the scan), and 'CASCADE' (chooses a cheap predictor, FASTLS, or WLS per pixel depending on the activity of its neighborhood). Other predictors contain 'NLM' (non-local means), 'MED' (LOCO-I median predictor), and 'MEAN' (average of neighborhood pixels) predictors.")));
 	parameters.insert(pair<string, GenericParameter*>("neighborhood_top", new Parameter<double>(2.5, 0,
 		"Size of ellipse neighborhood (top).")));
 	parameters.insert(pair<string, GenericParameter*>("neighborhood_left", new Parameter<double>(3.0, 0,
@@ -61,6 +63,8 @@ void Config::insertMoreParameters() {
 		"Size of training region (maximum pixel distance for values incorporated to training).")));
 	parameters.insert(pair<string, GenericParameter*>("training_size_3D", new Parameter<int>(0, 0,
 		"For 3-D training region: configure number of slices to include for training: 0 := only 2-D training region.")));
+	parameters.insert(pair<string, GenericParameter*>("training_decay", new Parameter<double>(0.0, 0,
+		"For the FASTLS predictor: weight each training pixel with this factor (between 0 and 1) to the power of its horizontal plus vertical distance instead of the box-shaped training region (0 := box-shaped training region; only 2-D training).")));
 	parameters.insert(pair<string, GenericParameter*>("variance", new Parameter<string>("LS", 0,
 		"Estimation of pixel intensities variance: RESIDUAL (from prediction error context), EXPONENTIAL (fast, default), or LS (analytically with LS).")));
 	parameters.insert(pair<string, GenericParameter*>("variance_radius", new Parameter<double>(4.5, 0,
@@ -69,6 +73,16 @@ void Config::insertMoreParameters() {
 		"Code transposed image if edges are rather horizontal.")));
 	parameters.insert(pair<string, GenericParameter*>("max_image_size", new Parameter<int>(8192, 0,
 		"Defines the maximum pixel extent of an image in x-, y-, and z-direction: for best performance choose about eight times the typical image size.")));
+	parameters.insert(pair<string, GenericParameter*>("threads", new Parameter<int>(1, 0,
+		"Number of threads (0 := number of CPU cores): the bitstream is identical for any number of threads (without substreams, decoding uses a single thread).")));
+	parameters.insert(pair<string, GenericParameter*>("substreams", new Parameter<string>("NONE", 0,
+		"Split the bitstream into substreams that can be encoded and decoded in parallel: NONE (default), WAVEFRONT (groups of rows, each one starting as soon as the previous group is far enough ahead), TILES (independently coded rectangular tiles), or CHANNELS (one substream per color channel or per slice of a 3-D image, each one lagging behind the previous one by the bottom rows of the context). Attention: the decoder must use the same setting!")));
+	parameters.insert(pair<string, GenericParameter*>("substream_rows", new Parameter<int>(1, 0,
+		"For substreams == WAVEFRONT: number of image rows per substream (the rows of one substream are coded one after another: more rows reduce the bitstream overhead but also the number of threads that can work in parallel).")));
+	parameters.insert(pair<string, GenericParameter*>("tile_width", new Parameter<int>(512, 0,
+		"For substreams == TILES: width of one tile in pixels (tiles at the image border may be smaller).")));
+	parameters.insert(pair<string, GenericParameter*>("tile_height", new Parameter<int>(512, 0,
+		"For substreams == TILES: height of one tile in pixels (tiles at the image border may be smaller).")));
 	parameters.insert(pair<string, GenericParameter*>("inter_channel_prediction", new Parameter<int>(2, 0,
 		"For multi-channel images, include corresponding pixel positions in previously transmitted channels into the prediction neighborhood.")));
 	parameters.insert(pair<string, GenericParameter*>("wls_variance_equation", new Parameter<int>(1, 0,
@@ -77,8 +91,36 @@ void Config::insertMoreParameters() {
 		"If larger than zero, use another neighborhood size (circle neighborhood) for matching to compute weights in WLS. This is useful if the image contains recurring structures. Attention: This has only an effect if it is greater than neighborhood_XXX sizes!")));
 	parameters.insert(pair<string, GenericParameter*>("max_training_vectors", new Parameter<int>(0, 0,
 		"If larger than zero, allow no more than this number of weights to be larger than zero in WLS. This is useful for non-local training (large training_size).")));
+	parameters.insert(pair<string, GenericParameter*>("exact_match", new Parameter<bool>(0, 0,
+		"If the neighborhood of a pixel occurred before exactly, predict the pixel value at that position with a small variance instead of running the predictor. Faster and more efficient for synthetic and screen content (prevents parallel encoding without substreams).")));
+	parameters.insert(pair<string, GenericParameter*>("patch_index", new Parameter<bool>(0, 0,
+		"Only for WLS with max_training_vectors: also consider similar patches from the whole previously coded image as training vectors. They are found in an index of coarsely quantized neighborhoods at constant cost per pixel, which is useful for images with recurring structures (prevents parallel encoding without substreams).")));
+	parameters.insert(pair<string, GenericParameter*>("batched_covariance", new Parameter<bool>(1, 0,
+		"Gather all training vectors of a pixel in a matrix and compute the covariance matrix of LS and WLS at once in cache-blocked tiles instead of one training vector after another (identical results, usually faster).")));
+	parameters.insert(pair<string, GenericParameter*>("sliding_covariance", new Parameter<bool>(0, 0,
+		"Only for LS: update the covariance matrix from pixel to pixel by adding the training positions that enter and subtracting those that leave the training region, in exact integer arithmetic (much faster for large training regions; results differ slightly from the floating-point accumulation). Attention: the decoder must use the same setting!")));
+	parameters.insert(pair<string, GenericParameter*>("exact_integrals", new Parameter<bool>(0, 0,
+		"Only for FASTLS with box-shaped training region: store the integral images of the outer products as packed upper triangles in 64-bit integers instead of full matrices in double precision (half the memory, exact results independent of the computation order). Attention: the decoder must use the same setting!")));
+	parameters.insert(pair<string, GenericParameter*>("precision", new Parameter<string>("DOUBLE", 0,
+		"Arithmetic precision of the neighborhood buffer and of the covariance matrix accumulation in LS and WLS: DOUBLE or FLOAT (half the buffer memory and faster, slightly different results; the system of equations is always solved in double precision). Stored in the bitstream.")));
 	parameters.insert(pair<string, GenericParameter*>("solver", new Parameter<int>(3, 0,
-		"Choose algorithm for solving linear system of equations: DECOMP_CHOLESKY (3) leads to faster solutions than DECOMP_QR (4) but sometimes decreases compression efficiency.")));
+		"Choose algorithm for solving linear system of equations: DECOMP_CHOLESKY (3) leads to faster solutions than DECOMP_QR (4) but sometimes decreases compression efficiency. SOLVER_CG (5) uses the conjugate gradient method warm-started from the solution for the previous pixel and falls back to DECOMP_CHOLESKY (prevents parallel encoding without substreams).")));
+	parameters.insert(pair<string, GenericParameter*>("reestimation_interval", new Parameter<int>(1, 0,
+		"Lazy LS: estimate and solve the system of equations of FASTLS, LS and WLS only for every n-th pixel of a row and reuse the coefficients in between (1 estimates for every pixel; larger values are faster but decrease compression efficiency).")));
+	parameters.insert(pair<string, GenericParameter*>("reestimation_threshold", new Parameter<double>(0.0, 0,
+		"Lazy LS: re-estimate as soon as the absolute prediction error of the previous pixel exceeds this multiple of the standard deviation of the training residuals (only with reestimation_interval larger than one; 0 disables this trigger).")));
+	parameters.insert(pair<string, GenericParameter*>("block_size", new Parameter<int>(32, 0,
+		"For the BLOCKLS predictor: width and height of the blocks in pixels that share one set of transmitted coefficients (smaller blocks adapt better but need more side information).")));
+	parameters.insert(pair<string, GenericParameter*>("block_coefficient_bits", new Parameter<int>(10, 0,
+		"For the BLOCKLS predictor: number of fractional bits of the quantized coefficients (1 to 16).")));
+	parameters.insert(pair<string, GenericParameter*>("forgetting_factor", new Parameter<double>(0.995, 0,
+		"For the RLS predictor: weight of each previous pixel relative to the following one along the scan (between 0 and 1; smaller values adapt faster but estimate less reliably, 1 weights all pixels of a slice equally).")));
+	parameters.insert(pair<string, GenericParameter*>("cascade_flat_predictor", new Parameter<string>("MED", 0,
+		"For the CASCADE predictor: cheap predictor for flat regions, 'MED' (LOCO-I median predictor on its own 3-pixel neighborhood) or 'MEAN' (average of neighborhood pixels).")));
+	parameters.insert(pair<string, GenericParameter*>("cascade_flat_threshold", new Parameter<double>(1.0, 0,
+		"For the CASCADE predictor: pixels whose neighborhood has a standard deviation up to this value (in 8-bit intensity units) are predicted by the cheap predictor. Attention: the decoder must use the same setting!")));
+	parameters.insert(pair<string, GenericParameter*>("cascade_texture_threshold", new Parameter<double>(6.0, 0,
+		"For the CASCADE predictor: pixels whose neighborhood has a larger standard deviation than this value (in 8-bit intensity units) are predicted by WLS, all others above cascade_flat_threshold by FASTLS. Attention: the decoder must use the same setting!")));
 	parameters.insert(pair<string, GenericParameter*>("border_regularization", new Parameter<double>(1.0, 0,
 		"Choose Tikhonov regularization strength for border image pixels.")));
 	parameters.insert(pair<string, GenericParameter*>("inner_regularization", new Parameter<double>(0.1, 0,
@@ -101,7 +143,12 @@ void Config::insertMoreParameters() {
 
 void Config::checkConfig() {
 	// check if config seems valid
-	if((get<string>("input") == "" && get<string>("bitstream") == "") || // at most an output filename or "show" was specified
+	if(get<string>("batch") != "") {
+		if(get<string>("bitstream") == "" && get<string>("output") == "") {
+			cerr << "Batch mode needs an output directory: -b for encoding or -o for decoding." << endl;
+			throw ConfigNotValidException();
+		}
+	} else if((get<string>("input") == "" && get<string>("bitstream") == "") || // at most an output filename or "show" was specified
 		(get<string>("bitstream") == "" && get<string>("output") == "" && !get<bool>("show")) || // at most an input filename was specified
 		(get<string>("input") == "" && get<string>("output") == "" && !get<bool>("show"))) { // at most a bitstream filename was specified
 			cout << "Input and output filenames are neither given in the config file nor as command line arguments. Starting interactive mode." << endl << endl;
@@ -127,7 +174,7 @@ void Config::checkConfig() {
 			}
 				
 	}
-	if(get<string>("predictor") != "MEAN" && get<string>("predictor") != "MED" && get<string>("predictor") != "NLM" && get<string>("predictor") != "FASTLS" && get<string>("predictor") != "LS" && get<string>("predictor") != "WLS") {
+	if(get<string>("predictor") != "MEAN" && get<string>("predictor") != "MED" && get<string>("predictor") != "NLM" && get<string>("predictor") != "FASTLS" && get<string>("predictor") != "LS" && get<string>("predictor") != "WLS" && get<string>("predictor") != "BLOCKLS" && get<string>("predictor") != "RLS" && get<string>("predictor") != "CASCADE") {
 		cerr << "Predictor not known." << endl;
 		throw ConfigNotValidException();
 	}
@@ -137,12 +184,97 @@ void Config::checkConfig() {
 		cerr << "For the MED predictor you need to set the neighborhood sizes to neighborhood_top=1.5 / neighborhood_left=1.5 / neighborhood_right=0.5 pixels (zero for bottom and front)." << endl;
 		throw ConfigNotValidException();
 	}
+	if(get<string>("cascade_flat_predictor") != "MED" && get<string>("cascade_flat_predictor") != "MEAN") {
+		cerr << "Cascade flat predictor not known." << endl;
+		throw ConfigNotValidException();
+	}
+	if(get<double>("cascade_flat_threshold") < 0.0) {
+		cout << "Warning: the cascade flat threshold must not be negative. Setting to zero." << endl;
+		set("cascade_flat_threshold", 0.0);
+	}
+	if(get<double>("cascade_texture_threshold") < get<double>("cascade_flat_threshold")) {
+		cout << "Warning: the cascade texture threshold must not be smaller than the flat threshold. Setting it to the flat threshold." << endl;
+		set("cascade_texture_threshold", get<double>("cascade_flat_threshold"));
+	}
 	if(get<string>("variance") != "RESIDUAL" && get<string>("variance") != "EXPONENTIAL" && get<string>("variance") != "LS") {
 		cerr << "Variance estimator not known." << endl;
 		throw ConfigNotValidException();
 	}
+	if(get<string>("precision") != "DOUBLE" && get<string>("precision") != "FLOAT") {
+		cerr << "Precision not known." << endl;
+		throw ConfigNotValidException();
+	}
+	if(get<bool>("patch_index") && ((get<string>("predictor") != "WLS" && get<string>("predictor") != "CASCADE") || get<int>("max_training_vectors") <= 0)) {
+		cout << "Warning: the patch index is only used by the WLS (or CASCADE) predictor with max_training_vectors. Deactivating patch_index." << endl;
+		set("patch_index", false);
+	}
+	if(get<double>("training_decay") < 0.0 || get<double>("training_decay") >= 1.0) {
+		cout << "Warning: the training decay must be at least zero and smaller than one. Using the box-shaped training region." << endl;
+		set("training_decay", 0.0);
+	}
+	if(get<double>("training_decay") > 0.0 && get<int>("training_size_3D")) {
+		cout << "Warning: the decaying training window only supports 2-D training regions. Using the box-shaped training region." << endl;
+		set("training_decay", 0.0);
+	}
+	if(get<bool>("sliding_covariance") && get<string>("predictor") != "LS") {
+		cout << "Warning: the sliding covariance matrix is only used by the LS predictor. Deactivating sliding_covariance." << endl;
+		set("sliding_covariance", false);
+	}
+	if(get<bool>("exact_integrals") && ((get<string>("predictor") != "FASTLS" && get<string>("predictor") != "CASCADE") || get<double>("training_decay") > 0.0)) {
+		cout << "Warning: exact integrals are only used by the FASTLS (or CASCADE) predictor with box-shaped training region. Deactivating exact_integrals." << endl;
+		set("exact_integrals", false);
+	}
+	if(get<int>("reestimation_interval") < 1) {
+		cout << "Warning: the reestimation interval must be positive. Setting to one." << endl;
+		set("reestimation_interval", 1);
+	}
+	if(get<double>("reestimation_threshold") < 0.0) {
+		cout << "Warning: the reestimation threshold must not be negative. Setting to zero." << endl;
+		set("reestimation_threshold", 0.0);
+	}
+	if(get<int>("block_size") < 1) {
+		cout << "Warning: a block must contain at least one pixel in each direction. Setting the block size to 32." << endl;
+		set("block_size", 32);
+	}
+	if(get<int>("block_coefficient_bits") < 1 || get<int>("block_coefficient_bits") > 16) {
+		cout << "Warning: the number of fractional coefficient bits must be between 1 and 16. Setting to 10." << endl;
+		set("block_coefficient_bits", 10);
+	}
+	if(get<double>("forgetting_factor") <= 0.0 || get<double>("forgetting_factor") > 1.0) {
+		cout << "Warning: the forgetting factor must be larger than zero and at most one. Setting to 0.995." << endl;
+		set("forgetting_factor", 0.995);
+	}
 	if(get<int>("max_image_size") > 40000)
 		cout << "Warning: is is not guaranteed that images with a size larger than 40000 pixels can be coded without problems." << endl;
+	if(get<int>("threads") < 0) {
+		cout << "Warning: the number of threads must not be negative. Setting to one." << endl;
+		set("threads", 1);
+	}
+	if(get<string>("substreams") != "NONE" && get<string>("substreams") != "WAVEFRONT" && get<string>("substreams") != "TILES" && get<string>("substreams") != "CHANNELS") {
+		cerr << "Substream mode not known." << endl;
+		throw ConfigNotValidException();
+	}
+	if((get<string>("substreams") == "WAVEFRONT" || get<string>("substreams") == "CHANNELS") && get<string>("predictor") == "BLOCKLS") {
+		cout << "Warning: the BLOCKLS predictor codes its coefficients in the main bitstream and cannot be used with wavefront or channel substreams. Deactivating substreams." << endl;
+		set<string>("substreams", "NONE");
+	}
+	if(get<string>("substreams") == "WAVEFRONT") {
+		if(get<string>("predictor") == "FASTLS" || get<string>("predictor") == "CASCADE") {
+			cout << "Warning: the FASTLS (and CASCADE) predictor cannot be used with wavefront substreams. Deactivating substreams." << endl;
+			set<string>("substreams", "NONE");
+		} else if(get<string>("variance") == "RESIDUAL") {
+			cout << "Warning: the RESIDUAL variance estimator cannot be used with wavefront substreams. Using EXPONENTIAL instead." << endl;
+			set<string>("variance", "EXPONENTIAL");
+		}
+		if(get<int>("substream_rows") < 1) {
+			cout << "Warning: a substream must contain at least one image row. Setting to one." << endl;
+			set("substream_rows", 1);
+		}
+	}
+	if(get<string>("substreams") == "TILES" && (get<int>("tile_width") < 1 || get<int>("tile_height") < 1)) {
+		cout << "Warning: tiles must contain at least one pixel in each direction. Setting the tile size to 512 x 512." << endl;
+		set("tile_width", 512); set("tile_height", 512);
+	}
 	if(get<int>("inter_channel_prediction") && get<double>("neighborhood_front") > 0.0 && get<int>("training_size_3D")) {
 		cout << "Warning: inter_channel_prediction is not possible with 3D neighborhood and/or training region. Setting to zero." << endl;
 		set("inter_channel_prediction", 0);
@@ -0,0 +1,63 @@
+// Copyright (c) 2015 Siemens AG, Author: Andreas Weinlich
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+#include "vanilcConjugateGradient.h"
+
+namespace vanilc {
+
+bool solveConjugateGradient(const Mat& A, const Mat& B, Mat& X, int maxIterations, double tolerance) {
+	const int n = A.rows;
+	const size_t bstep = B.step1(), xstep = X.step1();
+	AutoBuffer<double, 256> buffer(4 * n);
+	double *r = buffer, *z = r + n, *p = z + n, *q = p + n;
+	for(int c = 0; c < B.cols; ++c) {
+		const double* b = B.ptr<double>() + c;
+		double* x = X.ptr<double>() + c;
+		double bNorm = 0.0;
+		for(int i = 0; i < n; ++i) bNorm += b[i * bstep] * b[i * bstep];
+		const double maxResidualNorm = tolerance * tolerance * bNorm;
+		double rz = 0.0, rNorm = 0.0;
+		for(int i = 0; i < n; ++i) { // r = b - A x, z = M^-1 r
+			const double* APtr = A.ptr<double>(i);
+			if(!(APtr[i] > 0.0)) return false; // not positive definite
+			double s = b[i * bstep];
+			for(int j = 0; j < n; ++j) s -= APtr[j] * x[j * xstep];
+			r[i] = s;
+			p[i] = z[i] = s / APtr[i];
+			rz += s * z[i];
+			rNorm += s * s;
+		}
+		for(int iteration = 0; rNorm > maxResidualNorm; ++iteration) {
+			if(iteration == maxIterations) return false;
+			double pq = 0.0;
+			for(int i = 0; i < n; ++i) { // q = A p
+				const double* APtr = A.ptr<double>(i);
+				double s = 0.0;
+				for(int j = 0; j < n; ++j) s += APtr[j] * p[j];
+				q[i] = s;
+				pq += p[i] * s;
+			}
+			if(!(pq > 0.0)) return false; // not positive definite (or breakdown)
+			const double alpha = rz / pq;
+			double rzNew = 0.0;
+			rNorm = 0.0;
+			for(int i = 0; i < n; ++i) {
+				x[i * xstep] += alpha * p[i];
+				r[i] -= alpha * q[i];
+				z[i] = r[i] / A.ptr<double>(i)[i];
+				rzNew += r[i] * z[i];
+				rNorm += r[i] * r[i];
+			}
+			const double beta = rzNew / rz;
+			rz = rzNew;
+			for(int i = 0; i < n; ++i) p[i] = z[i] + beta * p[i];
+		}
+	}
+	return true;
+} // end solveConjugateGradient
+
+} // end namespace vanilc
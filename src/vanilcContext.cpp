@@ -11,7 +11,19 @@
 namespace vanilc {
 
 void Context::contextOf(const Point3i& position, Mat& destination) const {
-	if(useBuffer) {
+	if(useBuffer && buffer->depth() == CV_32F) { // convert buffered single precision values (pixel intensities are exactly representable)
+		float* bufPtr = buffer->ptr<float>(position.z * image->size[1] * image->size[2] + position.y * image->size[2] + position.x);
+		#ifdef WIN32
+			if(_isnan(bufPtr[neighborhood.getNumberOfElements() - 1])) neighborhood.extractVectorFromImage(*image, position, bufPtr);
+		#else
+			if(isnan(bufPtr[neighborhood.getNumberOfElements() - 1])) neighborhood.extractVectorFromImage(*image, position, bufPtr);
+		#endif
+		// reuse the memory of destination only if nobody else refers to it (callers may keep the previous context element)
+		if(!destination.refcount || *destination.refcount != 1 || destination.rows != 1 || destination.cols != buffer->cols || destination.type() != CV_64F)
+			destination = Mat(1, buffer->cols, CV_64F);
+		double* destinationPtr = destination.ptr<double>();
+		for(int l = 0; l < buffer->cols; ++l) destinationPtr[l] = bufPtr[l];
+	} else if(useBuffer) {
 		destination = buffer->row(position.z * image->size[1] * image->size[2] + position.y * image->size[2] + position.x); // create matrix wrapper around buffer row as return value
 		double* bufPtr = destination.ptr<double>();
 		#ifdef WIN32
@@ -38,6 +50,19 @@ int Context::getNextContextElement(Mat& destination) {
 	return 0;
 } // end Context::getNextContextElement
 
+// only positions whose full neighborhood lies inside the image are read from the buffer
+void Context::fillBuffer(unsigned int slice, const Range& rows, const Range& cols) {
+	if(!buffer || (int)slice < (int)fullNeighborhood.getFront()) return;
+	const int firstRow = max(rows.start, (int)fullNeighborhood.getTop()), lastRow = min(rows.end, image->size[1] - (int)fullNeighborhood.getBottom());
+	const int firstCol = max(cols.start, (int)fullNeighborhood.getLeft()), lastCol = min(cols.end, image->size[2] - (int)fullNeighborhood.getRight());
+	for(int k = firstRow; k < lastRow; ++k)
+		for(int l = firstCol; l < lastCol; ++l)
+			if(buffer->depth() == CV_32F) fullNeighborhood.extractVectorFromImage(*image, Point3i(l, k, slice),
+				buffer->ptr<float>(slice * image->size[1] * image->size[2] + k * image->size[2] + l));
+			else fullNeighborhood.extractVectorFromImage(*image, Point3i(l, k, slice),
+				buffer->ptr<double>(slice * image->size[1] * image->size[2] + k * image->size[2] + l));
+} // end Context::fillBuffer
+
 // in border regions shrink neighborhood and training region
 void Context::checkBorder(const Point3i& position) {
 	if(border) { neighborhood = fullNeighborhood; trainingregion = fullTrainingregion; border = false; croppedNeighborhood = false; } // reset context if previous prediction was at a border pixel
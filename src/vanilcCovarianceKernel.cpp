@@ -0,0 +1,193 @@
+// Copyright (c) 2015 Siemens AG, Author: Andreas Weinlich
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+#include "vanilcCovarianceKernel.h"
+
+#if (defined __GNUC__ && (__GNUC__ > 4 || __GNUC__ == 4 && __GNUC_MINOR__ >= 9) || defined _MSC_VER && _MSC_VER >= 1600) && (defined __x86_64__ || defined __i386__ || defined _M_X64 || defined _M_IX86)
+	#define VANILC_AVX // the AVX kernel is compiled for x86 processors and selected at runtime
+	#include <immintrin.h>
+	#ifdef __GNUC__
+		#define VANILC_AVX_FUNCTION __attribute__((target("avx")))
+	#else
+		#define VANILC_AVX_FUNCTION
+	#endif
+#endif
+
+#define GRAM_BLOCK_SIZE 64 // training vectors per cache block (two blocks of up to 32 doubles per vector fit into the L1 cache)
+#define GRAM_TILE_SIZE 4 // rows and columns of covMat accumulated in registers at once
+
+namespace vanilc {
+
+static void accumulateWeightedOuterProductScalar(double* covMat, size_t step, const double* sampleVector, const double* weightedSampleVector, int n) {
+	for(int k = 0; k < n; ++k) {
+		double* covMatPtr = covMat + k * step + k;
+		const double sampleValue = sampleVector[k];
+		for(int l = k; l < n; ++l) *(covMatPtr++) += sampleValue * weightedSampleVector[l];
+	}
+} // end accumulateWeightedOuterProductScalar
+
+#ifdef VANILC_AVX
+// four elements of a row at once (no fused multiply-add: its different rounding would break the encoder-decoder symmetry between machines)
+VANILC_AVX_FUNCTION static void accumulateWeightedOuterProductAVX(double* covMat, size_t step, const double* sampleVector, const double* weightedSampleVector, int n) {
+	for(int k = 0; k < n; ++k) {
+		double* covMatPtr = covMat + k * step;
+		const __m256d sampleValue = _mm256_set1_pd(sampleVector[k]);
+		int l = k;
+		for(; l + 4 <= n; l += 4)
+			_mm256_storeu_pd(covMatPtr + l, _mm256_add_pd(_mm256_loadu_pd(covMatPtr + l), _mm256_mul_pd(sampleValue, _mm256_loadu_pd(weightedSampleVector + l))));
+		for(; l < n; ++l) covMatPtr[l] += sampleVector[k] * weightedSampleVector[l];
+	}
+} // end accumulateWeightedOuterProductAVX
+#endif
+
+void accumulateWeightedOuterProduct(double* covMat, size_t step, const double* sampleVector, double weight, int n) {
+	AutoBuffer<double, 64> weightedSampleVector(n);
+	for(int l = 0; l < n; ++l) weightedSampleVector[l] = sampleVector[l] * weight;
+	#ifdef VANILC_AVX
+		static const bool avx = checkHardwareSupport(CV_CPU_AVX);
+		if(avx) {
+			accumulateWeightedOuterProductAVX(covMat, step, sampleVector, weightedSampleVector, n);
+			return;
+		}
+	#endif
+	accumulateWeightedOuterProductScalar(covMat, step, sampleVector, weightedSampleVector, n);
+} // end accumulateWeightedOuterProduct
+
+// one tile of covMat (rows x cols elements starting at row k and column l) over the training vectors of one cache block
+static inline void accumulateGramTileScalar(double* covMat, size_t step, const double* samples, const double* weightedSamples, size_t sampleStep, int count,
+		int k, int l, int rows, int cols) {
+	double sum[GRAM_TILE_SIZE][GRAM_TILE_SIZE];
+	for(int r = 0; r < rows; ++r) for(int c = 0; c < cols; ++c) sum[r][c] = covMat[(k + r) * step + l + c];
+	for(int i = 0; i < count; ++i, samples += sampleStep, weightedSamples += sampleStep)
+		for(int r = 0; r < rows; ++r) {
+			const double sampleValue = samples[k + r];
+			for(int c = 0; c < cols; ++c) sum[r][c] += sampleValue * weightedSamples[l + c];
+		}
+	for(int r = 0; r < rows; ++r) for(int c = 0; c < cols; ++c) covMat[(k + r) * step + l + c] = sum[r][c];
+} // end accumulateGramTileScalar
+
+#ifdef VANILC_AVX
+VANILC_AVX_FUNCTION static inline void accumulateGramTileAVX(double* covMat, size_t step, const double* samples, const double* weightedSamples, size_t sampleStep, int count,
+		int k, int l) {
+	double* covMatPtr = covMat + k * step + l;
+	__m256d sum0 = _mm256_loadu_pd(covMatPtr), sum1 = _mm256_loadu_pd(covMatPtr + step), sum2 = _mm256_loadu_pd(covMatPtr + 2 * step), sum3 = _mm256_loadu_pd(covMatPtr + 3 * step);
+	samples += k; weightedSamples += l;
+	for(int i = 0; i < count; ++i, samples += sampleStep, weightedSamples += sampleStep) {
+		const __m256d weightedSampleValues = _mm256_loadu_pd(weightedSamples);
+		sum0 = _mm256_add_pd(sum0, _mm256_mul_pd(_mm256_set1_pd(samples[0]), weightedSampleValues));
+		sum1 = _mm256_add_pd(sum1, _mm256_mul_pd(_mm256_set1_pd(samples[1]), weightedSampleValues));
+		sum2 = _mm256_add_pd(sum2, _mm256_mul_pd(_mm256_set1_pd(samples[2]), weightedSampleValues));
+		sum3 = _mm256_add_pd(sum3, _mm256_mul_pd(_mm256_set1_pd(samples[3]), weightedSampleValues));
+	}
+	_mm256_storeu_pd(covMatPtr, sum0); _mm256_storeu_pd(covMatPtr + step, sum1); _mm256_storeu_pd(covMatPtr + 2 * step, sum2); _mm256_storeu_pd(covMatPtr + 3 * step, sum3);
+} // end accumulateGramTileAVX
+
+// tile of four rows but less than four columns at the right end of covMat: vectorized along the column instead of the row
+template<int COLS>
+VANILC_AVX_FUNCTION static inline void accumulateGramColumnTileAVX(double* covMat, size_t step, const double* samples, const double* weightedSamples, size_t sampleStep, int count,
+		int k, int l) {
+	double* covMatPtr = covMat + k * step + l;
+	__m256d sum[COLS];
+	for(int c = 0; c < COLS; ++c) sum[c] = _mm256_set_pd(covMatPtr[3 * step + c], covMatPtr[2 * step + c], covMatPtr[step + c], covMatPtr[c]);
+	samples += k; weightedSamples += l;
+	for(int i = 0; i < count; ++i, samples += sampleStep, weightedSamples += sampleStep) {
+		const __m256d sampleValues = _mm256_loadu_pd(samples);
+		for(int c = 0; c < COLS; ++c) sum[c] = _mm256_add_pd(sum[c], _mm256_mul_pd(sampleValues, _mm256_set1_pd(weightedSamples[c])));
+	}
+	double column[GRAM_TILE_SIZE];
+	for(int c = 0; c < COLS; ++c) {
+		_mm256_storeu_pd(column, sum[c]);
+		for(int r = 0; r < GRAM_TILE_SIZE; ++r) covMatPtr[r * step + c] = column[r];
+	}
+} // end accumulateGramColumnTileAVX
+#endif
+
+void accumulateWeightedGramMatrix(double* covMat, size_t step, const double* samples, const double* weightedSamples, size_t sampleStep, int count, int n) {
+	#ifdef VANILC_AVX
+		static const bool avx = checkHardwareSupport(CV_CPU_AVX);
+	#endif
+	for(int block = 0; block < count; block += GRAM_BLOCK_SIZE) { // sum order per element stays the order of the training vectors
+		const int blockCount = min(GRAM_BLOCK_SIZE, count - block);
+		const double *blockSamples = samples + block * sampleStep, *blockWeightedSamples = weightedSamples + block * sampleStep;
+		for(int k = 0; k < n; k += GRAM_TILE_SIZE) {
+			const int rows = min(GRAM_TILE_SIZE, n - k);
+			for(int l = k; l < n; l += GRAM_TILE_SIZE) { // upper triangle (diagonal tiles completely)
+				const int cols = min(GRAM_TILE_SIZE, n - l);
+				if(rows == GRAM_TILE_SIZE && cols == GRAM_TILE_SIZE) { // full tile: constant loop bounds keep the sums in registers
+					#ifdef VANILC_AVX
+						if(avx) {
+							accumulateGramTileAVX(covMat, step, blockSamples, blockWeightedSamples, sampleStep, blockCount, k, l);
+							continue;
+						}
+					#endif
+					accumulateGramTileScalar(covMat, step, blockSamples, blockWeightedSamples, sampleStep, blockCount, k, l, GRAM_TILE_SIZE, GRAM_TILE_SIZE);
+				} else {
+					#ifdef VANILC_AVX
+						if(avx && rows == GRAM_TILE_SIZE) {
+							if(cols == 3) accumulateGramColumnTileAVX<3>(covMat, step, blockSamples, blockWeightedSamples, sampleStep, blockCount, k, l);
+							else if(cols == 2) accumulateGramColumnTileAVX<2>(covMat, step, blockSamples, blockWeightedSamples, sampleStep, blockCount, k, l);
+							else accumulateGramColumnTileAVX<1>(covMat, step, blockSamples, blockWeightedSamples, sampleStep, blockCount, k, l);
+							continue;
+						}
+					#endif
+					accumulateGramTileScalar(covMat, step, blockSamples, blockWeightedSamples, sampleStep, blockCount, k, l, rows, cols);
+				}
+			}
+		}
+	}
+} // end accumulateWeightedGramMatrix
+
+
+// single precision tile of four rows and eight columns (GRAM_PADDING) over the training vectors of one cache block
+static inline void accumulateGramTileScalar(float* covMat, size_t step, const float* samples, const float* weightedSamples, size_t sampleStep, int count, int k, int l) {
+	float sum[GRAM_TILE_SIZE][GRAM_PADDING];
+	for(int r = 0; r < GRAM_TILE_SIZE; ++r) for(int c = 0; c < GRAM_PADDING; ++c) sum[r][c] = covMat[(k + r) * step + l + c];
+	for(int i = 0; i < count; ++i, samples += sampleStep, weightedSamples += sampleStep)
+		for(int r = 0; r < GRAM_TILE_SIZE; ++r) {
+			const float sampleValue = samples[k + r];
+			for(int c = 0; c < GRAM_PADDING; ++c) sum[r][c] += sampleValue * weightedSamples[l + c];
+		}
+	for(int r = 0; r < GRAM_TILE_SIZE; ++r) for(int c = 0; c < GRAM_PADDING; ++c) covMat[(k + r) * step + l + c] = sum[r][c];
+} // end accumulateGramTileScalar
+
+#ifdef VANILC_AVX
+VANILC_AVX_FUNCTION static inline void accumulateGramTileAVX(float* covMat, size_t step, const float* samples, const float* weightedSamples, size_t sampleStep, int count, int k, int l) {
+	float* covMatPtr = covMat + k * step + l;
+	__m256 sum0 = _mm256_loadu_ps(covMatPtr), sum1 = _mm256_loadu_ps(covMatPtr + step), sum2 = _mm256_loadu_ps(covMatPtr + 2 * step), sum3 = _mm256_loadu_ps(covMatPtr + 3 * step);
+	samples += k; weightedSamples += l;
+	for(int i = 0; i < count; ++i, samples += sampleStep, weightedSamples += sampleStep) {
+		const __m256 weightedSampleValues = _mm256_loadu_ps(weightedSamples);
+		sum0 = _mm256_add_ps(sum0, _mm256_mul_ps(_mm256_set1_ps(samples[0]), weightedSampleValues));
+		sum1 = _mm256_add_ps(sum1, _mm256_mul_ps(_mm256_set1_ps(samples[1]), weightedSampleValues));
+		sum2 = _mm256_add_ps(sum2, _mm256_mul_ps(_mm256_set1_ps(samples[2]), weightedSampleValues));
+		sum3 = _mm256_add_ps(sum3, _mm256_mul_ps(_mm256_set1_ps(samples[3]), weightedSampleValues));
+	}
+	_mm256_storeu_ps(covMatPtr, sum0); _mm256_storeu_ps(covMatPtr + step, sum1); _mm256_storeu_ps(covMatPtr + 2 * step, sum2); _mm256_storeu_ps(covMatPtr + 3 * step, sum3);
+} // end accumulateGramTileAVX
+#endif
+
+void accumulateWeightedGramMatrix(float* covMat, size_t step, const float* samples, const float* weightedSamples, size_t sampleStep, int count, int n) {
+	#ifdef VANILC_AVX
+		static const bool avx = checkHardwareSupport(CV_CPU_AVX);
+	#endif
+	for(int block = 0; block < count; block += 2 * GRAM_BLOCK_SIZE) { // vectors have half the size in single precision
+		const int blockCount = min(2 * GRAM_BLOCK_SIZE, count - block);
+		const float *blockSamples = samples + block * sampleStep, *blockWeightedSamples = weightedSamples + block * sampleStep;
+		for(int k = 0; k < n; k += GRAM_TILE_SIZE)
+			for(int l = k - k % GRAM_PADDING; l < n; l += GRAM_PADDING) { // upper triangle (diagonal tiles completely)
+				#ifdef VANILC_AVX
+					if(avx) {
+						accumulateGramTileAVX(covMat, step, blockSamples, blockWeightedSamples, sampleStep, blockCount, k, l);
+						continue;
+					}
+				#endif
+				accumulateGramTileScalar(covMat, step, blockSamples, blockWeightedSamples, sampleStep, blockCount, k, l);
+			}
+	}
+} // end accumulateWeightedGramMatrix
+
+} // end namespace vanilc
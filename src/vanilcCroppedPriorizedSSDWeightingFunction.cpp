@@ -17,13 +17,12 @@ double CroppedPriorizedSSDWeightingFunction::computeWeight(const Point3i& spatia
 double CroppedPriorizedSSDWeightingFunction::computeWeight(const Mat& regressionPoint) {
 	double distance, result = 0.0;
 	const double* regressionPointPtr = regressionPoint.ptr<double>();
-	double thresholdDistance = bestDistances.at<double>(0, 0);
+	const double thresholdDistance = bestDistances.top();
 	for(int l = 0; l < referenceRegressionPoint.cols; ++l) {
 		distance = referenceRegressionPointPtr[l] - *(regressionPointPtr++);
 		if((result += neighborhoodPriorizationPtr[l] * distance * distance) > thresholdDistance) return 0.0;
 	}
-	bestDistances.at<double>(0, 0) = result;
-	cv::sort(bestDistances, bestDistances, CV_SORT_EVERY_ROW + CV_SORT_DESCENDING);
+	bestDistances.replaceTop(result);
 	return 1.0 / (1.0 + 0.00002 * result * result);
 } // end CroppedPriorizedSSDWeightingFunction::computeWeight
 
@@ -0,0 +1,103 @@
+// Copyright (c) 2015 Siemens AG, Author: Andreas Weinlich
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "vanilcDecayLSPredictor.h"
+
+namespace vanilc {
+
+void DecayLSPredictionComputer::init() {
+	const int numberOfElements = predictor->getContext().getFullNeighborhood().getNumberOfElements();
+	const int width = predictor->getContext().getImage()->size[2];
+	verticalSums = Mat(width, numberOfElements * numberOfElements + 1, CV_64F, Scalar(0.0));
+	outerProducts.create(width, numberOfElements * numberOfElements + 1, CV_64F);
+	horizontalSums.create(width, numberOfElements * numberOfElements + 1, CV_64F);
+	currentSum.create(1, numberOfElements * numberOfElements + 1, CV_64F);
+	sumSlice = sumRow = currentRow = currentColumn = -1;
+	effectiveTrainingVectors = -1.0;
+} // end DecayLSPredictionComputer::init
+
+int DecayLSPredictionComputer::getNumberOfTrainingVectors() const {
+	return effectiveTrainingVectors < 0.0 ? LSPredictionComputer::getNumberOfTrainingVectors() : cvRound(effectiveTrainingVectors);
+} // end DecayLSPredictionComputer::getNumberOfTrainingVectors
+
+// estimate covariance matrix
+void DecayLSPredictionComputer::estimate(const Point3i& currentPos) {
+	const StructuringElement& neighborhood = context->getFullNeighborhood();
+	if(context->getNeighborhood().getMask().total() != neighborhood.getMask().total()) {
+		LSPredictionComputer::estimate(currentPos); // if full neighborhood not yet available at border regions, for simplicity use WLS implementation
+		effectiveTrainingVectors = -1.0;
+	} else {
+		const int numberOfElements = neighborhood.getNumberOfElements(), size = numberOfElements * numberOfElements + 1;
+		if(currentPos.z != sumSlice) { // training starts anew in every slice
+			verticalSums = Scalar(0.0);
+			sumSlice = currentPos.z;
+			sumRow = neighborhood.getTop() - 1; // rows above have no full neighborhood
+			currentRow = -1;
+		}
+		while(sumRow < currentPos.y - 1) addRow(++sumRow, currentPos.z); // rows may have been skipped, e.g., if all their pixels were predicted otherwise
+		double* currentSumPtr = currentSum.ptr<double>();
+		if(currentPos.y != currentRow) {
+			currentSum = Scalar(0.0);
+			currentRow = currentPos.y;
+			currentColumn = neighborhood.getLeft() - 1;
+		}
+		while(currentColumn < currentPos.x - 1) { // include all pixels of the row up to the previous one (also those predicted otherwise)
+			outerProduct(Point3i(++currentColumn, currentPos.y, currentPos.z), outerProducts.ptr<double>(0));
+			const double* outerProductPtr = outerProducts.ptr<double>(0);
+			for(int i = 0; i < size; ++i) currentSumPtr[i] = decay * currentSumPtr[i] + outerProductPtr[i];
+		}
+		context->contextOf(currentPos, sampleVector); // get current neighborhood and store it in sampleVector
+		covMat->create(numberOfElements, numberOfElements + 1, CV_64F); // one more row for later variance estimation!
+		sampleVector.reshape(0, sampleVector.cols).copyTo(covMat->col(covMat->cols - 1)); // put neighborhood in last column for variance estimate
+		const double* verticalSumPtr = verticalSums.ptr<double>(currentPos.x);
+		for(int k = 0; k < numberOfElements; ++k) { // training pixels of the current row and of all previous rows are one step further away
+			double* covMatPtr = covMat->ptr<double>(k);
+			for(int l = 0; l < numberOfElements; ++l, ++currentSumPtr, ++verticalSumPtr) covMatPtr[l] = decay * (*currentSumPtr + *verticalSumPtr);
+		}
+		effectiveTrainingVectors = decay * (*currentSumPtr + *verticalSumPtr);
+		*covMat = covMat->rowRange(0, covMat->rows - 1); // make last row invisible for computePrediction function of WLS
+	}
+	*weights = weights->colRange(0, 0); // set used region
+} // end DecayLSPredictionComputer::estimate
+
+// verticalSums = decay * verticalSums + sum over the row of decay^|dx| * outer products (causal and anti-causal filter, the center counted once)
+void DecayLSPredictionComputer::addRow(int row, int slice) {
+	const int size = verticalSums.cols;
+	const int left = context->getFullNeighborhood().getLeft(), right = context->getImage()->size[2] - 1 - (int)context->getFullNeighborhood().getRight();
+	if(right < left) return; // image too narrow for a full neighborhood
+	for(int x = left; x <= right; ++x) {
+		double* outerProductPtr = outerProducts.ptr<double>(x);
+		outerProduct(Point3i(x, row, slice), outerProductPtr);
+		double* horizontalSumPtr = horizontalSums.ptr<double>(x);
+		if(x == left) for(int i = 0; i < size; ++i) horizontalSumPtr[i] = outerProductPtr[i];
+		else for(int i = 0; i < size; ++i) horizontalSumPtr[i] = decay * horizontalSumPtr[i - size] + outerProductPtr[i]; // rows are continuous
+	}
+	double* rightSumPtr = currentSum.ptr<double>(); // anti-causal sum (currentSum is recomputed for the next row anyway)
+	currentRow = -1;
+	for(int i = 0; i < size; ++i) rightSumPtr[i] = 0.0;
+	for(int x = right; x >= left; --x) {
+		const double* outerProductPtr = outerProducts.ptr<double>(x);
+		const double* horizontalSumPtr = horizontalSums.ptr<double>(x);
+		double* verticalSumPtr = verticalSums.ptr<double>(x);
+		for(int i = 0; i < size; ++i) {
+			rightSumPtr[i] = decay * rightSumPtr[i] + outerProductPtr[i];
+			verticalSumPtr[i] = decay * verticalSumPtr[i] + horizontalSumPtr[i] + rightSumPtr[i] - outerProductPtr[i];
+		}
+	}
+} // end DecayLSPredictionComputer::addRow
+
+void DecayLSPredictionComputer::outerProduct(const Point3i& position, double* outerProductPtr) {
+	context->contextOf(position, sampleVector);
+	const double* const sampleVectorPtr = sampleVector.ptr<double>();
+	for(int k = 0; k < sampleVector.cols; ++k)
+		for(int l = 0; l < sampleVector.cols; ++l)
+			*(outerProductPtr++) = sampleVectorPtr[k] * sampleVectorPtr[l];
+	*outerProductPtr = 1.0; // weight
+} // end DecayLSPredictionComputer::outerProduct
+
+} // end namespace vanilc
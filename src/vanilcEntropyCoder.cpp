@@ -73,6 +73,14 @@ unsigned int EntropyCoder::writeBitstream(ofstream& fs) {
 	return i * sizeof(STREAMTYPE);
 } // end EntropyCoder::writeBitstream
 
+// the reader position must not lie within the detached elements
+EntropyCoder::bitqueue EntropyCoder::detachBitstream(unsigned int numberOfElements) {
+	if(numberOfElements > bitstream.size()) throw EndOfBitstreamException();
+	bitqueue detached(bitstream.end() - numberOfElements, bitstream.end());
+	bitstream.erase(bitstream.end() - numberOfElements, bitstream.end());
+	return detached;
+} // end EntropyCoder::detachBitstream
+
 void EntropyCoder::reset() {
 	streamFront = 8 * sizeof(STREAMTYPE) - 1;
 	streamBack = 0;
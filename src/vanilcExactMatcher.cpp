@@ -0,0 +1,53 @@
+// Copyright (c) 2015 Siemens AG, Author: Andreas Weinlich
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+#include "vanilcExactMatcher.h"
+
+namespace vanilc {
+
+void ExactMatcher::init(const Context& context) {
+	size_t tableSize = 1024;
+	while(tableSize < 2 * context.getImage()->total() && tableSize < ((size_t)1 << 22)) tableSize <<= 1; // about half filled
+	table.assign(tableSize, Point3i(-1, -1, -1));
+	tableMask = tableSize - 1;
+	hit = previousHit = false;
+	meanSquaredError = EXACT_MATCH_MIN_VARIANCE;
+} // end ExactMatcher::init
+
+bool ExactMatcher::match(const Point3i& currentPos, const Context& context) {
+	if(previousHit) { // adapt the variance to the errors of matched predictions
+		const double error = context.getImage()->at<double>(previousPos.z, previousPos.y, previousPos.x) - prediction;
+		meanSquaredError += EXACT_MATCH_ADAPTATION * (error * error - meanSquaredError);
+	}
+	hit = previousHit = false;
+	if(context.getNeighborhood().getNumberOfElements() != context.getFullNeighborhood().getNumberOfElements()) return false; // cropped at the border
+	context.contextOf(currentPos, sampleVector);
+	const Mat neighbors = sampleVector.colRange(0, sampleVector.cols - 1); // without current pixel
+	Point3i& entry = table[hashOf(neighbors) & tableMask];
+	if(entry.x >= 0) {
+		context.contextOf(entry, candidateVector);
+		if(!memcmp(candidateVector.ptr<double>(), sampleVector.ptr<double>(), neighbors.cols * sizeof(double))) { // not only the same hash value
+			prediction = candidateVector.at<double>(candidateVector.cols - 1);
+			hit = previousHit = true;
+			previousPos = currentPos;
+		}
+	}
+	entry = currentPos; // its value is known when it is matched (for a later pixel)
+	return hit;
+} // end ExactMatcher::match
+
+size_t ExactMatcher::hashOf(const Mat& neighbors) const {
+	const double* neighborsPtr = neighbors.ptr<double>();
+	unsigned long long hash = 14695981039346656037ULL; // FNV-1a over the integer intensities
+	for(int l = 0; l < neighbors.cols; ++l) {
+		hash ^= (unsigned long long)(long long)neighborsPtr[l];
+		hash *= 1099511628211ULL;
+	}
+	return (size_t)(hash ^ (hash >> 32));
+} // end ExactMatcher::hashOf
+
+} // end namespace vanilc
@@ -14,18 +14,6 @@ double ExponentialSADWeightingFunction::computeWeight(const Point3i& spatialPoin
 	return 1;
 } // end ExponentialSADWeightingFunction::computeWeight
 
-double ExponentialSADWeightingFunction::computeWeight(const Mat& regressionPoint) {
-	double distance, result = 0.0;
-	const double* regressionPointPtr = regressionPoint.ptr<double>();
-	for(int l = 0; l < referenceRegressionPoint.cols; ++l) {
-		distance = referenceRegressionPointPtr[l] - *(regressionPointPtr++);
-		result += abs(distance);
-	}
-	result = exp(- result * decay);
-	if(result < 1e-300) throw DecayTooLargeException();
-	return result;
-} // end ExponentialSADWeightingFunction::computeWeight
-
 double ExponentialSADWeightingFunction::computeWeight(const Point3i& spatialPoint, const Mat& regressionPoint) {
 	return computeWeight(regressionPoint);
 } // end ExponentialSADWeightingFunction::computeWeight
@@ -11,10 +11,7 @@
 namespace vanilc {
 
 void FastLSPredictionComputer::init() {
-	int sz[] = {predictor->getContext().getImage()->size[0] - predictor->getContext().getFullNeighborhood().getMask().size[0] + 1, // covMatBuffer size
-		predictor->getContext().getImage()->size[1] - predictor->getContext().getFullNeighborhood().getMask().size[1] + 1,
-		predictor->getContext().getImage()->size[2] - predictor->getContext().getFullNeighborhood().getMask().size[2] + 1,
-		predictor->getContext().getFullNeighborhood().getNumberOfElements(), predictor->getContext().getFullNeighborhood().getNumberOfElements()};
+	int sz[] = {predictor->getContext().getImage()->size[0], predictor->getContext().getImage()->size[1], predictor->getContext().getImage()->size[2]}; // integral buffer size
 	if(predictor->getContext().getFullTrainingregion().getFront()) {
 		if(predictor->getContext().getFullTrainingregion().getFront() + 2 <= (unsigned int)sz[0]) // ringbuffered slices
 			sz[0] = predictor->getContext().getFullTrainingregion().getFront() + 2;
@@ -22,107 +19,182 @@ void FastLSPredictionComputer::init() {
 		if(predictor->getContext().getFullTrainingregion().getTop() + 2 <= (unsigned int)sz[1]) // ringbuffered rows
 			sz[1] = predictor->getContext().getFullTrainingregion().getTop() + 2;
 	}
-	covMatBuffer = Mat(5, sz, CV_64F, numeric_limits<double>::quiet_NaN());
-	zeroBuffer = Mat(predictor->getContext().getFullNeighborhood().getNumberOfElements(), predictor->getContext().getFullNeighborhood().getNumberOfElements(), CV_64F, Scalar(0.0));
-	currentSlice = predictor->getContext().getFullTrainingregion().getFront() + 1;
-	currentRow = predictor->getContext().getFullTrainingregion().getTop() + 1;
+	const int elements = predictor->getContext().getFullNeighborhood().getNumberOfElements();
+	elementSize = (exactIntegrals ? elements * (elements + 1) / 2 : elements * elements); // packed upper triangles or full matrices
+	if(exactIntegrals) {
+		packedIntegrals.buffer.assign((size_t)sz[0] * sz[1] * sz[2] * elementSize, 0);
+		packedIntegrals.zeroRow.assign((size_t)sz[2] * elementSize, 0);
+	} else {
+		floatingIntegrals.buffer.assign((size_t)sz[0] * sz[1] * sz[2] * elementSize, 0.0);
+		floatingIntegrals.zeroRow.assign((size_t)sz[2] * elementSize, 0.0);
+	}
+	fullElements.resize(elements);
+	for(int k = 0; k < elements; ++k) fullElements[k] = k;
+	filledColumns.assign(sz[0] * sz[1], 0);
+	for(int i = 0; i < 3; ++i) bufferSize[i] = sz[i];
+	currentSlice = currentRow = -1;
+	firstSlice = -1;
 } // end FastLSPredictionComputer::init
 
+template<> FastLSPredictionComputer::Integrals<double>& FastLSPredictionComputer::getIntegrals<double>() { return floatingIntegrals; }
+template<> FastLSPredictionComputer::Integrals<uint64>& FastLSPredictionComputer::getIntegrals<uint64>() { return packedIntegrals; }
+
+// outer product of a sample vector: full matrix of doubles or packed upper triangle of integers (pixel values are non-negative integers)
+static inline void outerProduct(const double* sampleVectorPtr, int elements, double* destinationPtr) {
+	for(int k = 0; k < elements; ++k)
+		for(int l = 0; l < elements; ++l) *(destinationPtr++) = sampleVectorPtr[k] * sampleVectorPtr[l];
+}
+static inline void outerProduct(const double* sampleVectorPtr, int elements, uint64* destinationPtr) {
+	for(int k = 0; k < elements; ++k) {
+		const uint64 value = (uint64)cvRound(sampleVectorPtr[k]);
+		for(int l = k; l < elements; ++l) *(destinationPtr++) = value * (uint64)cvRound(sampleVectorPtr[l]);
+	}
+}
+static inline double toDouble(double value) { return value; }
+static inline double toDouble(uint64 value) { return (double)(int64)value; } // the box sums are small enough to be represented exactly
+
 // estimate covariance matrix
 void FastLSPredictionComputer::estimate(const Point3i& currentPos) {
-	if(context->getNeighborhood().getMask().total() != context->getFullNeighborhood().getMask().total())
-		LSPredictionComputer::estimate(currentPos); // if full neighborhood not yet available at border regions, for simplicity use WLS implementation
-	else {
-		Mat sampleVector;
-		context->contextOf(currentPos, sampleVector); // get current neighborhood and store it in sampleVector
-		covMat->create(context->getFullNeighborhood().getNumberOfElements(), context->getFullNeighborhood().getNumberOfElements() + 1, CV_64F); // one more row for later variance estimation!
-		sampleVector.reshape(0, sampleVector.cols).copyTo(covMat->col(covMat->cols - 1)); // put neighborhood in last column for variance estimate
-		int left = context->getTrainingregion().getLeft(), right = context->getTrainingregion().getRight(), top = context->getTrainingregion().getTop();
-		(*covMat)(Rect(0, 0, sampleVector.cols, sampleVector.cols))
-			= getBuffer(currentPos + Point3i(     -1,      0, 0))
-			- getBuffer(currentPos + Point3i(     -1,     -1, 0))
-			+ getBuffer(currentPos + Point3i(  right,     -1, 0))
-			- getBuffer(currentPos + Point3i(-1-left,      0, 0))
-			- getBuffer(currentPos + Point3i(  right, -1-top, 0))
-			+ getBuffer(currentPos + Point3i(-1-left, -1-top, 0));
-		if(context->getTrainingregion().getFront()) { // 3-D training region
-			int bottom = context->getTrainingregion().getBottom(), front = context->getTrainingregion().getFront();
-			(*covMat)(Rect(0, 0, sampleVector.cols, sampleVector.cols)) +=
-				- getBuffer(currentPos + Point3i(     -1,      0, -1      ))
-				+ getBuffer(currentPos + Point3i(     -1,     -1, -1      ))
-				- getBuffer(currentPos + Point3i(  right,     -1, -1      ))
-				+ getBuffer(currentPos + Point3i(-1-left,      0, -1      ))
-				+ getBuffer(currentPos + Point3i(  right, bottom, -1      ))
-				- getBuffer(currentPos + Point3i(-1-left, bottom, -1      ))
-				- getBuffer(currentPos + Point3i(  right, bottom, -1-front))
-				+ getBuffer(currentPos + Point3i(-1-left, bottom, -1-front))
-				+ getBuffer(currentPos + Point3i(  right, -1-top, -1-front))
-				- getBuffer(currentPos + Point3i(-1-left, -1-top, -1-front));
-		}
-		*covMat = covMat->rowRange(0, covMat->rows - 1); // make last row invisible for computePrediction function of WLS
-//		context->getContextElementsOf(currentPos); // only necessary if computeVariance method from parent class WLS is used
+	if(firstSlice < 0) // integrals start at the first slice of the training region (substreams may start at any slice of the image)
+		firstSlice = max(0, currentPos.z - (int)context->getFullTrainingregion().getFront());
+	const vector<int>* elements = &fullElements;
+	if(context->getNeighborhood().getNumberOfElements() != context->getFullNeighborhood().getNumberOfElements()) { // neighborhood cropped at image borders
+		croppedElements.clear(); // the covariances of the remaining elements are a submatrix of the box sum (neighbors outside of the image are zero)
+		const StructuringElement& fullNeighborhood = context->getFullNeighborhood();
+		Point3i maskPosition(-1, 0, 0);
+		for(int k = 0; !fullNeighborhood.increment(maskPosition); ++k)
+			if(context->getNeighborhood().contains(maskPosition - fullNeighborhood.getAnchor())) croppedElements.push_back(k);
+		elements = &croppedElements;
 	}
+	Mat sampleVector;
+	context->contextOf(currentPos, sampleVector); // get current neighborhood and store it in sampleVector
+	covMat->create(context->getFullNeighborhood().getNumberOfElements(), context->getFullNeighborhood().getNumberOfElements() + 1, CV_64F); // one more row for later variance estimation!
+	*covMat = (*covMat)(Rect(0, 0, sampleVector.cols + 1, sampleVector.cols)); // Rect(x, y, width, height)
+	sampleVector.reshape(0, sampleVector.cols).copyTo(covMat->col(covMat->cols - 1)); // put neighborhood in last column for variance estimate
+	if(exactIntegrals) sumIntegrals<uint64>(currentPos, *elements);
+	else sumIntegrals<double>(currentPos, *elements);
+	*covMat = covMat->rowRange(0, covMat->rows - 1); // make last row invisible for computePrediction function of WLS
 	*weights = weights->colRange(0, 0); // set used region
 } // end FastLSPredictionComputer::estimate
 
-Mat FastLSPredictionComputer::getBuffer(const Point3i& currentPos) {
-	int pos[] = {currentPos.z - context->getFullNeighborhood().getFront(), currentPos.y - context->getFullNeighborhood().getTop(),
-		currentPos.x - context->getFullNeighborhood().getLeft(), 0, 0}; // buffer position
-	if(pos[0] < 0 || pos[1] < 0 || pos[2] < 0 || pos[2] >= covMatBuffer.size[2] ||
-		pos[1] >= context->getImage()->size[1] - context->getFullNeighborhood().getMask().size[1] + 1)
-			return zeroBuffer; // outside the buffer return zero matrix
-	if(pos[0] >= covMatBuffer.size[0]) { // slice ringbuffer is active
-		if(pos[0] > (int)currentSlice) { // rotate ringbuffer
-			pos[0] %= covMatBuffer.size[0]; // ringbuffer position
-			int startSlice[] = {pos[0], 0, 0, 0, 0};
-			for(double *nanPtr = &(covMatBuffer.at<double>(startSlice)),
-				*endPtr = nanPtr + covMatBuffer.size[1] * covMatBuffer.size[2] * covMatBuffer.size[3] * covMatBuffer.size[4];
-				nanPtr < endPtr; nanPtr += covMatBuffer.size[3] * covMatBuffer.size[4])
-					*nanPtr = numeric_limits<double>::quiet_NaN(); // set upper left matrix values to nan
-			++currentSlice;
-			currentRow = context->getTrainingregion().getTop() + 1;
-		} else pos[0] %= covMatBuffer.size[0];
+// inclusion-exclusion of the integrals at the corners of the training region, written element by element into covMat
+template<typename T> void FastLSPredictionComputer::sumIntegrals(const Point3i& currentPos, const vector<int>& elements) {
+	const int left = context->getTrainingregion().getLeft(), right = context->getTrainingregion().getRight(), top = context->getTrainingregion().getTop();
+	const int bottom = context->getTrainingregion().getBottom(), front = context->getTrainingregion().getFront();
+	const bool volumetric = (context->getFullTrainingregion().getFront() != 0); // 3-D integrals contain the previous slices even if front is cropped to zero
+	rotateBuffer<T>(currentPos);
+	const T* corners[16]; // corners of the 2-D box in the current slice, then of the 3-D box in the previous slices
+	corners[0] = getIntegral<T>(currentPos + Point3i(     -1,      0, 0));
+	corners[1] = getIntegral<T>(currentPos + Point3i(     -1,     -1, 0));
+	corners[2] = getIntegral<T>(currentPos + Point3i(  right,     -1, 0));
+	corners[3] = getIntegral<T>(currentPos + Point3i(-1-left,      0, 0));
+	corners[4] = getIntegral<T>(currentPos + Point3i(  right, -1-top, 0));
+	corners[5] = getIntegral<T>(currentPos + Point3i(-1-left, -1-top, 0));
+	if(volumetric) { // 3-D training region
+		corners[ 6] = getIntegral<T>(currentPos + Point3i(     -1,      0, -1      ));
+		corners[ 7] = getIntegral<T>(currentPos + Point3i(     -1,     -1, -1      ));
+		corners[ 8] = getIntegral<T>(currentPos + Point3i(  right,     -1, -1      ));
+		corners[ 9] = getIntegral<T>(currentPos + Point3i(-1-left,      0, -1      ));
+		corners[10] = getIntegral<T>(currentPos + Point3i(  right, bottom, -1      ));
+		corners[11] = getIntegral<T>(currentPos + Point3i(-1-left, bottom, -1      ));
+		corners[12] = getIntegral<T>(currentPos + Point3i(  right, bottom, -1-front));
+		corners[13] = getIntegral<T>(currentPos + Point3i(-1-left, bottom, -1-front));
+		corners[14] = getIntegral<T>(currentPos + Point3i(  right, -1-top, -1-front));
+		corners[15] = getIntegral<T>(currentPos + Point3i(-1-left, -1-top, -1-front));
+	}
+	const int n = context->getFullNeighborhood().getNumberOfElements();
+	for(int k = 0; k < covMat->rows; ++k) { // upper triangle (the integrals are symmetric), mirrored to the lower one
+		const int a = elements[k];
+		const size_t rowOffset = (exactIntegrals ? a * n - a * (a + 1) / 2 : a * n); // packed upper triangles or full matrices
+		double* covMatPtr = covMat->ptr<double>(k);
+		for(int l = k; l < covMat->rows; ++l) {
+			const size_t i = rowOffset + elements[l];
+			T value = corners[0][i] - corners[1][i] + corners[2][i] - corners[3][i] - corners[4][i] + corners[5][i];
+			if(volumetric)
+				value = value + (- corners[6][i] + corners[7][i] - corners[8][i] + corners[9][i] + corners[10][i] - corners[11][i]
+					- corners[12][i] + corners[13][i] + corners[14][i] - corners[15][i]);
+			covMatPtr[l] = covMat->at<double>(l, k) = toDouble(value);
+		}
 	}
-	if(!context->getTrainingregion().getFront()) { // row ringbuffer is active
-		if(pos[1] > (int)currentRow) { // rotate ringbuffer
-			pos[1] %= covMatBuffer.size[1]; // ringbuffer position
-			int startRow[] = {0, pos[1], 0, 0, 0};
-			for(double *nanPtr = &(covMatBuffer.at<double>(startRow)),
-				*endPtr = nanPtr + covMatBuffer.size[2] * covMatBuffer.size[3] * covMatBuffer.size[4];
-				nanPtr < endPtr; nanPtr += covMatBuffer.size[3] * covMatBuffer.size[4])
-					*nanPtr = numeric_limits<double>::quiet_NaN(); // set upper left matrix values to nan
-			++currentRow;
-		} else pos[1] %= covMatBuffer.size[1];
+} // end FastLSPredictionComputer::sumIntegrals
+
+// the ringbuffers follow the coding position (not the corners of the training region, which may lie in previous slices)
+template<typename T> void FastLSPredictionComputer::rotateBuffer(const Point3i& currentPos) {
+	if(currentPos.z > currentSlice) { // rotate slice ringbuffer (the first slice need not be the first one of the image: substreams)
+		if(currentSlice >= 0 && context->getFullTrainingregion().getFront()) // sequential coding: the slice left is completely known, sweep its remaining rows
+			fillIntegrals<T>(currentSlice, context->getImage()->size[1] - 1, bufferSize[2] - 1);
+		for(int slice = max(currentSlice + 1, currentPos.z - bufferSize[0] + 1); slice <= currentPos.z; ++slice)
+			fill(filledColumns.begin() + (slice % bufferSize[0]) * bufferSize[1], filledColumns.begin() + (slice % bufferSize[0] + 1) * bufferSize[1], 0);
+		currentSlice = currentPos.z;
+		currentRow = -1;
+	}
+	if(currentPos.y > currentRow) { // rotate row ringbuffer (rows may have been skipped, e.g., if all their pixels were predicted otherwise)
+		for(int row = currentRow + 1; row <= currentPos.y; ++row) {
+			if(row) fillIntegrals<T>(currentSlice, row - 1, bufferSize[2] - 1); // the rows above are known: sweep them completely ahead of the coding position
+			filledColumns[entryOf(currentSlice, row)] = 0;
+		}
+		currentRow = currentPos.y;
+	}
+} // end FastLSPredictionComputer::rotateBuffer
+
+template<typename T> const T* FastLSPredictionComputer::getIntegral(const Point3i& currentPos) {
+	if(currentPos.z < firstSlice || currentPos.y < 0 || currentPos.x < 0 || currentPos.x >= bufferSize[2] || currentPos.y >= context->getImage()->size[1])
+		return &getIntegrals<T>().zeroRow[0]; // outside the buffer (or before the first slice) return zero matrix
+	fillIntegrals<T>(currentPos.z, currentPos.y, currentPos.x);
+	return &getIntegrals<T>().buffer[((size_t)entryOf(currentPos.z, currentPos.y) * bufferSize[2] + currentPos.x) * elementSize];
+} // end FastLSPredictionComputer::getIntegral
+
+// the filled prefixes do not grow from top to bottom or from previous to next slices (each row needs the row above and the one in the previous slice):
+// find the first row of each slice that is not filled far enough and sweep the rows from there on, without any recursion
+template<typename T> void FastLSPredictionComputer::fillIntegrals(int slice, int row, int column) {
+	if(filledColumns[entryOf(slice, row)] > column) return;
+	int firstFill = slice;
+	if(context->getFullTrainingregion().getFront())
+		while(firstFill > firstSlice && filledColumns[entryOf(firstFill - 1, row)] <= column) --firstFill;
+	for(int s = firstFill; s <= slice; ++s) {
+		int r = row;
+		while(r > 0 && filledColumns[entryOf(s, r - 1)] <= column) --r;
+		for(; r <= row; ++r) sweepRow<T>(s, r, column);
+	}
+} // end FastLSPredictionComputer::fillIntegrals
+
+template<typename T> void FastLSPredictionComputer::sweepRow(int slice, int row, int column) {
+	int& filled = filledColumns[entryOf(slice, row)];
+	if(filled > column) return;
+	Integrals<T>& integrals = getIntegrals<T>();
+	const size_t rowSize = (size_t)bufferSize[2] * elementSize;
+	T* const rowPtr = &integrals.buffer[entryOf(slice, row) * rowSize];
+	const T* const zeroPtr = &integrals.zeroRow[0];
+	// streaming pass: outer products of the sample vectors (independent of each other)
+	const int elements = context->getFullNeighborhood().getNumberOfElements();
+	AutoBuffer<double, 64> sampleVector(elements);
+	double* const sampleVectorPtr = sampleVector;
+	for(int x = filled; x <= column; ++x) {
+		context->getFullNeighborhood().extractVectorFromImageZeroPadded(*context->getImage(), Point3i(x, row, slice), sampleVectorPtr);
+		outerProduct(sampleVectorPtr, elements, rowPtr + x * elementSize);
 	}
-	double* bufPtr = &(covMatBuffer.at<double>(pos));
-	#ifdef WIN32
-	if(_isnan(*bufPtr)) {
-	#else
-	if(isnan(*bufPtr)) {
-	#endif
-		double* currentBufPtr = bufPtr;
-		const double*    leftBufPtr = getBuffer(currentPos + Point3i(-1,  0, 0)).ptr<double>();
-		const double*     topBufPtr = getBuffer(currentPos + Point3i( 0, -1, 0)).ptr<double>();
-		const double* topleftBufPtr = getBuffer(currentPos + Point3i(-1, -1, 0)).ptr<double>();
-		Mat sampleVector;
-		context->contextOf(currentPos, sampleVector);
-		const double* const sampleVectorPtr = sampleVector.ptr<double>();
-		for(int k = 0; k < sampleVector.cols; ++k) // matrix is continuous!
-			for(int l = 0; l < sampleVector.cols; ++l)
-				*(currentBufPtr++) = sampleVectorPtr[k] * sampleVectorPtr[l] + *(topBufPtr++) + *(leftBufPtr++) - *(topleftBufPtr++);
-		if(context->getTrainingregion().getFront()) { // 3-D training region
-			const double*        frontBufPtr = getBuffer(currentPos + Point3i( 0,  0, -1)).ptr<double>();
-			const double*    frontleftBufPtr = getBuffer(currentPos + Point3i(-1,  0, -1)).ptr<double>();
-			const double*     fronttopBufPtr = getBuffer(currentPos + Point3i( 0, -1, -1)).ptr<double>();
-			const double* fronttopleftBufPtr = getBuffer(currentPos + Point3i(-1, -1, -1)).ptr<double>();
-			currentBufPtr = bufPtr;
-			for(int k = 0; k < sampleVector.cols; ++k)
-				for(int l = 0; l < sampleVector.cols; ++l)
-					*(currentBufPtr++) += *(frontBufPtr++) - *(frontleftBufPtr++) - *(fronttopBufPtr++) + *(fronttopleftBufPtr++);
+	// prefix pass: add the integrals above, to the left (and in the previous slice), all rows are read and written contiguously
+	const bool volumetric = (context->getFullTrainingregion().getFront() && slice > firstSlice);
+	const T* const topRowPtr = (row ? &integrals.buffer[entryOf(slice, row - 1) * rowSize] : zeroPtr);
+	const T* const frontRowPtr = (volumetric ? &integrals.buffer[entryOf(slice - 1, row) * rowSize] : zeroPtr);
+	const T* const fronttopRowPtr = (volumetric && row ? &integrals.buffer[entryOf(slice - 1, row - 1) * rowSize] : zeroPtr);
+	for(int x = filled; x <= column; ++x) {
+		const size_t offset = x * elementSize, leftOffset = (x ? offset - elementSize : 0);
+		T* const currentPtr = rowPtr + offset;
+		const T* const topPtr = topRowPtr + offset;
+		const T* const leftPtr = (x ? rowPtr : zeroPtr) + leftOffset;
+		const T* const topleftPtr = (x ? topRowPtr : zeroPtr) + leftOffset;
+		for(int i = 0; i < elementSize; ++i) currentPtr[i] = currentPtr[i] + topPtr[i] + leftPtr[i] - topleftPtr[i];
+		if(volumetric) { // 3-D training region
+			const T* const frontPtr = frontRowPtr + offset;
+			const T* const frontleftPtr = (x ? frontRowPtr : zeroPtr) + leftOffset;
+			const T* const fronttopPtr = fronttopRowPtr + offset;
+			const T* const fronttopleftPtr = (x ? fronttopRowPtr : zeroPtr) + leftOffset;
+			for(int i = 0; i < elementSize; ++i) currentPtr[i] += frontPtr[i] - frontleftPtr[i] - fronttopPtr[i] + fronttopleftPtr[i];
 		}
 	}
-	return Mat(context->getFullNeighborhood().getNumberOfElements(), context->getFullNeighborhood().getNumberOfElements(), CV_64F, bufPtr);
-} // end FastLSPredictionComputer::updateBuffer
+	filled = column + 1;
+} // end FastLSPredictionComputer::sweepRow
 
 } // end namespace vanilc
 
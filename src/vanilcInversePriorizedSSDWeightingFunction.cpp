@@ -24,15 +24,5 @@ Mat InversePriorizedSSDWeightingFunction::constructInverseEuclideanPriorization(
 	return priorization / norm(priorization, NORM_L1);
 } // end InversePriorizedSSDWeightingFunction::constructInverseEuclideanPriorization
 
-double InversePriorizedSSDWeightingFunction::computeWeight(const Mat& regressionPoint) {
-	double distance, result = 0.0, meanRefValue = 0.0, varRefValue = 0.0, meanDstValue = 0.0;
-	const double* regressionPointPtr = regressionPoint.ptr<double>();
-	for(int l = 0; l < referenceRegressionPoint.cols; ++l) {
-		distance = (referenceRegressionPointPtr[l] - *(regressionPointPtr++)) * neighborhoodPriorizationPtr[l];
-		result += distance * distance;
-	}
-	return maxval / (maxval + result);
-} // end InversePriorizedSSDWeightingFunction::computeWeight
-
 } // end namespace vanilc
 
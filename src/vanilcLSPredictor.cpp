@@ -12,12 +12,24 @@ namespace vanilc {
 
 double LSPredictionComputer::compute(const Point3i& currentPos, Context* context) {
 	this->context = context;
+	reestimated = true;
 	if(!context->getTrainingregion().getNumberOfElements()) { // first 4 pixels / 8 voxels in image
 		context->contextOf(currentPos, *coefficients); // misuse coefficients vector to store neighbors for variance computation
 		if(coefficients->cols > 1) // not the first pixel
 			return coefficients->at<double>(coefficients->cols - 1) = mean(coefficients->colRange(0, coefficients->cols - 1))[0];
 		else return (1.0 + predictor->getMaxval()) / 2.0; // first pixel of image
 	}
+	if(isLazy()) {
+		fetchCurrentSample(currentPos);
+		if(keepCoefficients(currentPos, referenceSample.cols)) { // linear prediction with the coefficients of a previous pixel
+			reestimated = false;
+			setReferencePoint(currentPos); // weighting functions must see the reference points of all pixels
+			if(isIndexed()) index.insert(index.keyOf(referenceSample), currentPos);
+			double prediction = referenceSample.dot(reusedCoefficients);
+			previousPos = currentPos;
+			return previousPrediction = (prediction < 0.0 ? 0.0 : (prediction > predictor->getMaxval() ? predictor->getMaxval() : prediction)); // crop to valid value range
+		}
+	}
 	estimate(currentPos);
 	coefficients->create(covMat->rows + 1, 2, CV_64F); // reset to maximum size (should not need memory re-allocation)
 	*coefficients = coefficients->rowRange(0, covMat->rows); // set used region
@@ -33,40 +45,105 @@ double LSPredictionComputer::compute(const Point3i& currentPos, Context* context
 		} else solveSystem();
 	} else solveSystem();
 	double prediction = covMat->col(covMat->cols - 1).dot(coefficients->col(0)); // linear prediction using dot product
-	return (prediction < 0.0 ? 0.0 : (prediction > predictor->getMaxval() ? predictor->getMaxval() : prediction)); // crop to valid value range
+	prediction = (prediction < 0.0 ? 0.0 : (prediction > predictor->getMaxval() ? predictor->getMaxval() : prediction)); // crop to valid value range
+	if(isLazy()) { // keep coefficients and standard deviation of the training residuals (as in the LS variance equation) for the following pixels
+		transpose(coefficients->col(0), reusedCoefficients);
+		double sumOfSquaredResiduals = (covMat->ptr<double>())[(context->getFullNeighborhood().getNumberOfElements() + 1) * covMat->rows + covMat->cols - 2]
+			- covMat->col(covMat->cols - 2).dot(coefficients->col(0));
+		double sumOfWeights = weights->cols ? sum(*weights)[0] : getNumberOfTrainingVectors();
+		residualDeviation = (sumOfSquaredResiduals > 0.0 && sumOfWeights > 0.0 ? sqrt(sumOfSquaredResiduals / sumOfWeights) : 0.0);
+		pixelsSinceEstimation = 0;
+		estimationPos = previousPos = currentPos;
+		previousPrediction = prediction;
+	}
+	return prediction;
 } // end LSPredictionComputer::compute
 
-// estimate covariance matrix
-void LSPredictionComputer::estimate(const Point3i& currentPos) {
-	Mat sampleVector, weightedSampleVector;
-	context->contextOf(currentPos, sampleVector); // get current neighborhood and store it in sampleVector
+// lazy LS: decide whether the coefficients of the last estimation are reused for the current pixel (only depends on already coded pixels)
+bool LSPredictionComputer::keepCoefficients(const Point3i& currentPos, int numberOfNeighbors) {
+	if(reusedCoefficients.cols != numberOfNeighbors || currentPos.y != estimationPos.y || currentPos.z != estimationPos.z)
+		return false; // neighborhood changed at the border or new row (the covariance ring buffer of FASTLS must see every row)
+	if(++pixelsSinceEstimation >= reestimationInterval) return false;
+	if(reestimationThreshold > 0.0) { // residual of the previous pixel exceeds the expected deviation: model is outdated
+		const double residual = context->getImage()->at<double>(previousPos.z, previousPos.y, previousPos.x) - previousPrediction;
+		if(abs(residual) > reestimationThreshold * residualDeviation) return false;
+	}
+	return true;
+} // end LSPredictionComputer::keepCoefficients
 
-	// init covMat
-	covMat->create(context->getFullNeighborhood().getNumberOfElements(), context->getFullNeighborhood().getNumberOfElements() + 1, CV_64F);
-	*covMat = (*covMat)(Rect(0, 0, sampleVector.cols + 1, sampleVector.cols)); // Rect(x, y, width, height)
-	*covMat = Scalar(0.0); // set covariance matrix to zero
-	sampleVector.reshape(0, sampleVector.cols).copyTo(covMat->col(covMat->cols - 1)); // put neighborhood in last column for variance estimate
-	sampleVector = sampleVector.colRange(0, sampleVector.cols - 1); // remove last (current) pixel
+// weighting functions may adapt to all reference points they have seen (e.g. maximum intensity), so they must see skipped pixels as well
+void LSPredictionComputer::advance(const Point3i& currentPos, Context* context) {
+	this->context = context;
+	if(!context->getTrainingregion().getNumberOfElements()) return; // no weighting for first pixels in image
+	if(!weightingContext) fetchCurrentSample(currentPos);
+	setReferencePoint(currentPos);
+} // end LSPredictionComputer::advance
 
+// the neighbors are copied into referenceSample, which the weighting function keeps as reference point: the scratch rows stay unshared
+// (Context::contextOf only reuses the memory of unshared rows for the single precision buffer)
+void LSPredictionComputer::fetchCurrentSample(const Point3i& currentPos) {
+	context->contextOf(currentPos, currentSample); // get current neighborhood and store it in currentSample
+	currentSample.colRange(0, currentSample.cols - 1).copyTo(referenceSample); // remove last (current) pixel
+} // end LSPredictionComputer::fetchCurrentSample
+
+void LSPredictionComputer::setReferencePoint(const Point3i& currentPos) {
 	// other neighborhood is used for matching (weight computation) than for prediction?
-	Mat weightingVector;
 	if(weightingContext) {
 		weightingContext->checkBorder(currentPos);
 		if(weightingContext->isBorder()) context->setTrainingregion(weightingContext->getTrainingregion()); // use smaller training region for context
-		weightingContext->contextOf(currentPos, weightingVector); // get current matching neighborhood and store it in weightingVector
-		weightingVector = weightingVector.colRange(0, weightingVector.cols - 1); // remove last (current) pixel
-		otherWeightingFunction->setReferencePoint(weightingVector); // set as reference for block matching to compute weights
+		weightingContext->contextOf(currentPos, weightingSample); // get current matching neighborhood and store it in weightingSample
+		weightingSample.colRange(0, weightingSample.cols - 1).copyTo(weightingReference); // remove last (current) pixel
+		otherWeightingFunction->setReferencePoint(weightingReference); // set as reference for block matching to compute weights
 		weightingContext->getContextElementsOf(currentPos);
-	} else weightingFunction->setReferencePoint(sampleVector); // set as reference for block matching to compute weights
+	} else weightingFunction->setReferencePoint(referenceSample); // set as reference for block matching to compute weights
+} // end LSPredictionComputer::setReferencePoint
+
+template<class WF>
+void LSPredictionComputer::accumulateTrainingVectors(WF& weightingFunction, const Point3i& currentPos, Mat& sampleVector, double* weightsPtr) {
+	context->getContextElementsOf(currentPos);
+	while(!context->getNextContextElement(sampleVector)) {
+		const double weight = *(weightsPtr++) = weightingFunction.WF::computeWeight(sampleVector); // do weighting for WLS and store weight
+		addTrainingVector(sampleVector, weight);
+	}
+} // end LSPredictionComputer::accumulateTrainingVectors
+
+// estimate covariance matrix
+void LSPredictionComputer::estimate(const Point3i& currentPos) {
+	fetchCurrentSample(currentPos);
+
+	// init covMat
+	covMat->create(context->getFullNeighborhood().getNumberOfElements(), context->getFullNeighborhood().getNumberOfElements() + 1, CV_64F);
+	*covMat = (*covMat)(Rect(0, 0, currentSample.cols + 1, currentSample.cols)); // Rect(x, y, width, height)
+	*covMat = Scalar(0.0); // set covariance matrix to zero
+	currentSample.reshape(0, currentSample.cols).copyTo(covMat->col(covMat->cols - 1)); // put neighborhood in last column for variance estimate
+
+	setReferencePoint(currentPos);
+	Mat& sampleVector = trainingSample; // training loops: private scratch row for each context element
+	Mat& weightingVector = weightingSample;
 
 	// init weights
-	weights->create(1, context->getFullTrainingregion().getNumberOfElements(), CV_64F); // reset to maximum size (should not need memory re-allocation)
+	weights->create(1, max((int)context->getFullTrainingregion().getNumberOfElements(), maxTrainingVectors), CV_64F); // reset to maximum size (should not need memory re-allocation)
 	*weights = weights->colRange(0, context->getTrainingregion().getNumberOfElements()); // set used region
 	double* weightsPtr = weights->ptr<double>();
+	if(singlePrecision) { // reset to maximum size (should not need memory re-allocation)
+		trainingVectors.create(max((int)context->getFullTrainingregion().getNumberOfElements(), maxTrainingVectors),
+			alignSize(context->getFullNeighborhood().getNumberOfElements(), GRAM_PADDING), CV_32F);
+		weightedTrainingVectors.create(trainingVectors.rows, trainingVectors.cols, CV_32F);
+		numberOfTrainingVectors = 0;
+	} else if(batchedCovariance) { // reset to maximum size (should not need memory re-allocation)
+		trainingVectors.create(max((int)context->getFullTrainingregion().getNumberOfElements(), maxTrainingVectors), context->getFullNeighborhood().getNumberOfElements(), CV_64F);
+		weightedTrainingVectors.create(trainingVectors.rows, trainingVectors.cols, CV_64F);
+		numberOfTrainingVectors = 0;
+	}
 
 	if(maxTrainingVectors) {
 		Mat sampleVectors(maxTrainingVectors, context->getNeighborhood().getNumberOfElements(), CV_64F, Scalar(0.0));
 		Mat correspondingWeights(maxTrainingVectors, 1, CV_64F, Scalar(0.0));
+		vector<pair<double, int> > slots(maxTrainingVectors);
+		for(int i = 0; i < maxTrainingVectors; ++i) slots[i] = make_pair(0.0, i);
+		BoundedHeap<pair<double, int>, greater<pair<double, int> > > smallestWeight(slots.begin(), slots.end()); // (weight, slot): smallest weight on top, first slot for equal weights
+		nonLocalTraining = isIndexed();
+		const int key = (nonLocalTraining ? index.keyOf(referenceSample) : 0);
 		context->getContextElementsOf(currentPos);
 		while(!context->getNextContextElement(sampleVector)) {
 			if(weightingContext) {
@@ -74,39 +151,71 @@ void LSPredictionComputer::estimate(const Point3i& currentPos) {
 				*weightsPtr = otherWeightingFunction->computeWeight(weightingVector);
 			} else *weightsPtr = weightingFunction->computeWeight(sampleVector); // do weighting for WLS and store weight
 			if(*(weightsPtr++)) {
-				int index[2];
-				minMaxIdx(correspondingWeights, NULL, NULL, index);
-				correspondingWeights.at<double>(index[0], 0) = *(weightsPtr - 1);
-				sampleVector.copyTo(sampleVectors.row(index[0]));
+				const int slot = smallestWeight.top().second; // replace the training vector with the smallest weight
+				smallestWeight.replaceTop(make_pair(correspondingWeights.at<double>(slot, 0) = *(weightsPtr - 1), slot));
+				sampleVector.copyTo(sampleVectors.row(slot));
 			}
 		}
-		double minWeight; minMaxIdx(correspondingWeights, &minWeight, NULL);
-		weightsPtr = weights->ptr<double>() - 1;
-		for(int i = 0; i < weights->cols; ++i) if(*(++weightsPtr) < minWeight) *weightsPtr = 0; // set small weights to zero
-		for(int i = 0; i < maxTrainingVectors; ++i) {
-			weightedSampleVector = sampleVectors.row(i) * correspondingWeights.at<double>(i, 0);
-			const double* const sampleVectorPtr = sampleVectors.ptr<double>(i);
-			const double* const weightedSampleVectorPtr = weightedSampleVector.ptr<double>();
-			for(int k = 0; k < covMat->rows; ++k) {
-				double* covMatPtr = covMat->ptr<double>(k) + k;
-				for(int l = k; l < sampleVector.cols; ++l) *(covMatPtr++) += sampleVectorPtr[k] * weightedSampleVectorPtr[l];
+		if(nonLocalTraining) { // further candidates: similar patches from the whole previously coded image
+			const vector<Point3i>& candidates = index.getBucket(key);
+			for(size_t i = 0; i < candidates.size(); ++i) {
+				if(context->getTrainingregion().contains(candidates[i] - currentPos)) continue; // already seen in the training region
+				context->contextOf(candidates[i], sampleVector);
+				double weight;
+				if(weightingContext) {
+					weightingContext->contextOf(candidates[i], weightingVector);
+					weight = otherWeightingFunction->computeWeight(weightingVector);
+				} else weight = weightingFunction->computeWeight(sampleVector);
+				if(weight) {
+					const int slot = smallestWeight.top().second;
+					smallestWeight.replaceTop(make_pair(correspondingWeights.at<double>(slot, 0) = weight, slot));
+					sampleVector.copyTo(sampleVectors.row(slot));
+				}
 			}
+			weights->create(1, maxTrainingVectors, CV_64F); // the weights belong to the selected training vectors
+			weightsPtr = weights->ptr<double>();
+			for(int i = 0; i < maxTrainingVectors; ++i)
+				if(correspondingWeights.at<double>(i, 0)) // only filled slots
+					addTrainingVector(sampleVectors.row(i).colRange(0, context->getNeighborhood().getNumberOfElements()), *(weightsPtr++) = correspondingWeights.at<double>(i, 0));
+			*weights = weights->colRange(0, (int)(weightsPtr - weights->ptr<double>()));
+			index.insert(key, currentPos); // after the query: the current pixel is not known yet
+		} else {
+			const double minWeight = smallestWeight.top().first;
+			weightsPtr = weights->ptr<double>() - 1;
+			for(int i = 0; i < weights->cols; ++i) if(*(++weightsPtr) < minWeight) *weightsPtr = 0; // set small weights to zero
+			for(int i = 0; i < maxTrainingVectors; ++i)
+				addTrainingVector(sampleVectors.row(i).colRange(0, context->getNeighborhood().getNumberOfElements()), correspondingWeights.at<double>(i, 0));
 		}
-	} else {
+	} else if(!weightingContext && typeid(*weightingFunction) == typeid(InversePriorizedSSDWeightingFunction))
+		accumulateTrainingVectors(*static_cast<InversePriorizedSSDWeightingFunction*>(weightingFunction), currentPos, sampleVector, weightsPtr);
+	else if(!weightingContext && typeid(*weightingFunction) == typeid(InversePriorizedSQDWeightingFunction))
+		accumulateTrainingVectors(*static_cast<InversePriorizedSQDWeightingFunction*>(weightingFunction), currentPos, sampleVector, weightsPtr);
+	else if(!weightingContext && typeid(*weightingFunction) == typeid(IdentityWeightingFunction)) // LS
+		accumulateTrainingVectors(*static_cast<IdentityWeightingFunction*>(weightingFunction), currentPos, sampleVector, weightsPtr);
+	else {
 		context->getContextElementsOf(currentPos);
 		while(!context->getNextContextElement(sampleVector)) {
 			if(weightingContext) {
 				weightingContext->getNextContextElement(weightingVector);
-				weightedSampleVector = sampleVector * (*(weightsPtr++) = otherWeightingFunction->computeWeight(weightingVector));
-			} else weightedSampleVector = sampleVector * (*(weightsPtr++) = weightingFunction->computeWeight(sampleVector)); // do weighting for WLS and store weight
-			const double* const sampleVectorPtr = sampleVector.ptr<double>();
-			const double* const weightedSampleVectorPtr = weightedSampleVector.ptr<double>();
-			for(int k = 0; k < covMat->rows; ++k) {
-				double* covMatPtr = covMat->ptr<double>(k) + k;
-				for(int l = k; l < sampleVector.cols; ++l) *(covMatPtr++) += sampleVectorPtr[k] * weightedSampleVectorPtr[l];
-			}
+				*weightsPtr = otherWeightingFunction->computeWeight(weightingVector);
+			} else *weightsPtr = weightingFunction->computeWeight(sampleVector); // do weighting for WLS and store weight
+			addTrainingVector(sampleVector, *(weightsPtr++));
 		}
 	}
+	if(singlePrecision) { // X' * W * X (and X' * W * y) accumulated in single precision and converted for the double precision solution
+		const int paddedSize = alignSize(covMat->rows, GRAM_PADDING);
+		singleCovMat.create(trainingVectors.cols, trainingVectors.cols, CV_32F); // maximum size (should not need memory re-allocation)
+		singleCovMat(Rect(0, 0, paddedSize, paddedSize)) = Scalar(0.0);
+		accumulateWeightedGramMatrix(singleCovMat.ptr<float>(), singleCovMat.step1(), trainingVectors.ptr<float>(), weightedTrainingVectors.ptr<float>(), trainingVectors.step1(),
+			numberOfTrainingVectors, paddedSize);
+		for(int k = 0; k < covMat->rows; ++k) {
+			const float* singleCovMatPtr = singleCovMat.ptr<float>(k);
+			double* covMatPtr = covMat->ptr<double>(k);
+			for(int l = k; l < covMat->rows; ++l) covMatPtr[l] = singleCovMatPtr[l];
+		}
+	} else if(batchedCovariance) // X' * W * X (and X' * W * y in the last column) of all training vectors at once
+		accumulateWeightedGramMatrix(covMat->ptr<double>(), covMat->step1(), trainingVectors.ptr<double>(), weightedTrainingVectors.ptr<double>(), trainingVectors.step1(),
+			numberOfTrainingVectors, covMat->rows);
 	*covMat = covMat->rowRange(0, covMat->rows - 1); // make last row invisible for computePrediction function of WLS
 	for(int k = 1; k < covMat->rows; ++k) { // copy values from upper triangular matrix
 		double* covMatPtr = covMat->ptr<double>(k);
@@ -114,8 +223,29 @@ void LSPredictionComputer::estimate(const Point3i& currentPos) {
 	}
 } // end LSPredictionComputer::estimate
 
+// sum of squared residuals weighted with squared weights computed from the training vectors gathered in estimate (no further pass over the training region)
+// the weights are squared in place like in LSVarianceComputer::compute; returns false if the training vectors were not gathered for the current pixel
+bool LSPredictionComputer::sumOfSquaredTrainingResiduals(const Mat& residualCoefficients, double& sumOfSquaredResiduals) {
+	if(!(batchedCovariance || singlePrecision) || (maxTrainingVectors && !nonLocalTraining) || numberOfTrainingVectors != weights->cols) return false;
+	double* weightsPtr = weights->ptr<double>();
+	Mat trainingVector(1, residualCoefficients.cols, CV_64F);
+	sumOfSquaredResiduals = 0.0;
+	for(int i = 0; i < numberOfTrainingVectors; ++i) {
+		if(singlePrecision) { // exact conversion (the values were converted from double)
+			const float* trainingVectorsPtr = trainingVectors.ptr<float>(i);
+			double* trainingVectorPtr = trainingVector.ptr<double>();
+			for(int l = 0; l < residualCoefficients.cols; ++l) trainingVectorPtr[l] = trainingVectorsPtr[l];
+		} else trainingVector = Mat(1, residualCoefficients.cols, CV_64F, trainingVectors.ptr<double>(i));
+		const double residual = residualCoefficients.dot(trainingVector);
+		*weightsPtr *= *weightsPtr;
+		sumOfSquaredResiduals += residual * residual * *(weightsPtr++);
+	}
+	return true;
+} // end LSPredictionComputer::sumOfSquaredTrainingResiduals
+
 
 double LSVarianceComputer::compute(const Point3i& currentPos, Context* context) {
+	if(predictionComputer && !predictionComputer->isReestimated()) return variance; // coefficients of a previous pixel were reused
 	if(!context->getTrainingregion().getNumberOfElements()) {
 		if(coefficients->cols < 3) {
 			if(coefficients->cols < 2) return predictor->getMaxval() * predictor->getMaxval() * .25; // first image pixel (use heuristic)
@@ -130,7 +260,6 @@ double LSVarianceComputer::compute(const Point3i& currentPos, Context* context)
 
 	double sumOfSquaredResiduals = 0.0;
 	if(wlsVarianceEquation) {
-		Mat sampleVector;
 		double residual;
 	//	double wSum = 0.0, numer = 0.0, denom = 0.0, weight, residualsum = 0.0, weightsum = 0.0, p = 0.0, q = 0.0, squaredWeight, weightsSum = 0.0;
 		*coefficients = coefficients->col(0);
@@ -162,21 +291,23 @@ double LSVarianceComputer::compute(const Point3i& currentPos, Context* context)
 	//	if(q < 1e-5) q = 1e-5;
 	//	if(p < 0) p = 0;
 	//	q /= p + q;
-		double* weightsPtr = weights->ptr<double>();
-		context->getContextElementsOf();
-		while(!context->getNextContextElement(sampleVector)) {
-			residual = coefficients->dot(sampleVector);
-	//		weight = 1.0 / ((1.0 / *(weightsPtr)) * numer + 1.0);
-	//		weight = 1.0 / ((1.0 / *(weightsPtr) - 1.0) * q + 1.0);
-	//		weight = 1.0 / ((1.0 / *(weightsPtr++) - 1.0) * 10.0 + 1.0);
-	//		wSum += *weightsPtr;
-			*weightsPtr *= *weightsPtr;
-	//		weightsSum += squaredWeight = *weightsPtr * *(weightsPtr++);
-	//		weightsSum += squaredWeight = weight * *(weightsPtr++);
-	//		weightsSum += squaredWeight = weight;
-	//		weightsSum += squaredWeight = *(weightsPtr++);
-	//		sumOfSquaredResiduals += residual * residual * squaredWeight;
-			sumOfSquaredResiduals += residual * residual * *(weightsPtr++);
+		if(!predictionComputer || !predictionComputer->sumOfSquaredTrainingResiduals(*coefficients, sumOfSquaredResiduals)) { // second pass over the training region
+			double* weightsPtr = weights->ptr<double>();
+			context->getContextElementsOf();
+			while(!context->getNextContextElement(sampleVector)) {
+				residual = coefficients->dot(sampleVector);
+		//		weight = 1.0 / ((1.0 / *(weightsPtr)) * numer + 1.0);
+		//		weight = 1.0 / ((1.0 / *(weightsPtr) - 1.0) * q + 1.0);
+		//		weight = 1.0 / ((1.0 / *(weightsPtr++) - 1.0) * 10.0 + 1.0);
+		//		wSum += *weightsPtr;
+				*weightsPtr *= *weightsPtr;
+		//		weightsSum += squaredWeight = *weightsPtr * *(weightsPtr++);
+		//		weightsSum += squaredWeight = weight * *(weightsPtr++);
+		//		weightsSum += squaredWeight = weight;
+		//		weightsSum += squaredWeight = *(weightsPtr++);
+		//		sumOfSquaredResiduals += residual * residual * squaredWeight;
+				sumOfSquaredResiduals += residual * residual * *(weightsPtr++);
+			}
 		}
 	} else {
 		sumOfSquaredResiduals = (covMat->ptr<double>())[(context->getFullNeighborhood().getNumberOfElements() + 1) * covMat->rows + covMat->cols - 2]
@@ -185,14 +316,14 @@ double LSVarianceComputer::compute(const Point3i& currentPos, Context* context)
 	}
 
 	// [sum of squared residuals] * [weights normalization factor (mean of all weights shall be 1)] * [factor to consider coefficients estimation error] / [DOF]
-	if(weights->cols) return sumOfSquaredResiduals * (double)weights->cols * (1.0 + coeffEstErrorFactor) / (predictor->computeDegreesOfFreedom() * sum(*weights)[0]);
-	else return sumOfSquaredResiduals * (1.0 + coeffEstErrorFactor) / predictor->computeDegreesOfFreedom();
+	if(weights->cols) return variance = sumOfSquaredResiduals * (double)weights->cols * (1.0 + coeffEstErrorFactor) / (predictor->computeDegreesOfFreedom() * sum(*weights)[0]);
+	else return variance = sumOfSquaredResiduals * (1.0 + coeffEstErrorFactor) / predictor->computeDegreesOfFreedom();
 } // end LSVarianceComputer::compute
 
 
 double LSDegreesOfFreedomComputer::compute(const Point3i& currentPos, Context* context) {
 	if(!context->getTrainingregion().getNumberOfElements()) return 1.0;
-	int dof = context->getTrainingregion().getNumberOfElements() - covMat->rows; // n - k
+	int dof = (predictionComputer ? predictionComputer->getNumberOfTrainingVectors() : context->getTrainingregion().getNumberOfElements()) - covMat->rows; // n - k
 	return (dof < 1 ? 1 : dof);
 } // end LSDegreesOfFreedomComputer::compute
 
@@ -10,6 +10,17 @@
 
 namespace vanilc {
 
+template<class WF>
+double NLMPredictionComputer::weightedMean(WF& weightingFunction, const Point3i& currentPos, Context* context, Mat& sampleVector) {
+	double weight, sumOfWeights = 0.0, prediction = 0.0;
+	context->getContextElementsOf(currentPos);
+	while(!context->getNextContextElement(sampleVector)) {
+		sumOfWeights += (weight = weightingFunction.WF::computeWeight(sampleVector));
+		prediction += sampleVector.at<double>(0, sampleVector.cols - 1) * weight;
+	}
+	return prediction / sumOfWeights;
+} // end NLMPredictionComputer::weightedMean
+
 double NLMPredictionComputer::compute(const Point3i& currentPos, Context* context) {
 	double prediction = 0.0;
 	Mat sampleVector;
@@ -17,13 +28,17 @@ double NLMPredictionComputer::compute(const Point3i& currentPos, Context* contex
 	if(context->getTrainingregion().getNumberOfElements()) {
 		sampleVector = sampleVector.colRange(0, sampleVector.cols - 1); // remove last (current) pixel
 		weightingFunction->setReferencePoint(sampleVector); // set as reference for block matching to compute weights
-		double weight, sumOfWeights = 0.0;
-		context->getContextElementsOf(currentPos);
-		while(!context->getNextContextElement(sampleVector)) {
-			sumOfWeights += (weight = weightingFunction->computeWeight(sampleVector));
-			prediction += sampleVector.at<double>(0, sampleVector.cols - 1) * weight;
+		if(typeid(*weightingFunction) == typeid(ExponentialSADWeightingFunction))
+			prediction = weightedMean(*static_cast<ExponentialSADWeightingFunction*>(weightingFunction), currentPos, context, sampleVector);
+		else {
+			double weight, sumOfWeights = 0.0;
+			context->getContextElementsOf(currentPos);
+			while(!context->getNextContextElement(sampleVector)) {
+				sumOfWeights += (weight = weightingFunction->computeWeight(sampleVector));
+				prediction += sampleVector.at<double>(0, sampleVector.cols - 1) * weight;
+			}
+			prediction /= sumOfWeights;
 		}
-		prediction /= sumOfWeights;
 		prediction = (prediction < 0.0 ? 0.0 : (prediction > predictor->getMaxval() ? predictor->getMaxval() : prediction)); // crop to valid value range
 	} else { // first 4 pixels / 8 voxels in image
 		if(context->getNeighborhood().getNumberOfElements() > 1) { // not the first pixel
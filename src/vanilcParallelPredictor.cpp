@@ -0,0 +1,62 @@
+// Copyright (c) 2015 Siemens AG, Author: Andreas Weinlich
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "vanilcParallelPredictor.h"
+
+namespace vanilc {
+
+void ParallelPredictor::addWorker(Predictor* predictor, Context* weightingContext, const Point3i& startPos) {
+	workers.push_back(predictor);
+	weightingContexts.push_back(weightingContext);
+	nextPositions.push_back(startPos);
+} // end ParallelPredictor::addWorker
+
+void ParallelPredictor::clear() {
+	for(unsigned int i = 0; i < workers.size(); ++i) {
+		delete workers[i];
+		if(weightingContexts[i]) delete weightingContexts[i];
+	}
+	workers.clear(); weightingContexts.clear(); nextPositions.clear();
+} // end ParallelPredictor::clear
+
+void ParallelPredictor::computeRows(unsigned int slice, const Range& rows, Mat& results) {
+	this->slice = slice; this->rows = rows; this->results = &results;
+	parallel_for_(Range(0, workers.size()), *this, workers.size());
+} // end ParallelPredictor::computeRows
+
+// the buffer of the main predictor must be complete before worker threads share it
+void ParallelPredictor::fillBuffer(Predictor& predictor, unsigned int slice, unsigned int height) {
+	parallel_for_(Range(0, height), BufferFiller(predictor, slice), workers.size());
+} // end ParallelPredictor::fillBuffer
+
+void ParallelPredictor::operator()(const Range& range) const {
+	const Mat* image = workers[0]->getContext().getImage();
+	for(int t = range.start; t < range.end; ++t) {
+		Predictor* predictor = workers[t];
+		const Point3i startPos(0, rows.start + rows.size() * t / workers.size(), slice);
+		const int endRow = rows.start + rows.size() * (t + 1) / workers.size();
+		if(startPos.y == endRow) continue; // more threads than rows
+		// skip pixels of other threads (in raster order)
+		Point3i& pos = nextPositions[t];
+		while(pos != startPos) {
+			predictor->skipPrediction(pos);
+			if(++pos.x == image->size[2]) { pos.x = 0; if(++pos.y == image->size[1]) { pos.y = 0; ++pos.z; }}
+		}
+		for(int k = startPos.y; k < endRow; ++k) {
+			double* resultsPtr = &(results->at<double>(k - rows.start, 0, 0));
+			for(int l = 0; l < image->size[2]; ++l) {
+				*(resultsPtr++) = predictor->computePrediction(Point3i(l, k, slice));
+				*(resultsPtr++) = predictor->computeVariance();
+				*(resultsPtr++) = predictor->computeDegreesOfFreedom();
+			}
+		}
+		pos = (endRow == image->size[1] ? Point3i(0, 0, slice + 1) : Point3i(0, endRow, slice));
+	}
+} // end ParallelPredictor::operator()
+
+} // end namespace vanilc
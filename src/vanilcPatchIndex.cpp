@@ -0,0 +1,47 @@
+// Copyright (c) 2015 Siemens AG, Author: Andreas Weinlich
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+#include "vanilcPatchIndex.h"
+#include "vanilcDefinitions.h"
+#include "vanilcInversePriorizedSSDWeightingFunction.h"
+
+namespace vanilc {
+
+void PatchIndex::init(const StructuringElement& neighborhood, unsigned int maxval, int bucketSize) {
+	this->maxval = maxval;
+	this->bucketSize = bucketSize;
+	Mat priorization = InversePriorizedSSDWeightingFunction::constructInverseEuclideanPriorization(neighborhood); // the larger the nearer
+	keyNeighbors.clear();
+	for(int i = 0; i < PATCH_INDEX_KEY_NEIGHBORS && i < priorization.cols; ++i) {
+		Point maxLoc;
+		minMaxLoc(priorization, NULL, NULL, NULL, &maxLoc); // first of equally near neighbors
+		keyNeighbors.push_back(maxLoc.x);
+		priorization.at<double>(maxLoc.x) = -1.0;
+	}
+	int numberOfKeys = 1;
+	for(size_t i = 0; i < keyNeighbors.size(); ++i) numberOfKeys *= PATCH_INDEX_LEVELS;
+	buckets.assign(numberOfKeys, vector<Point3i>());
+	insertions.assign(numberOfKeys, 0);
+} // end PatchIndex::init
+
+int PatchIndex::keyOf(const Mat& sampleVector) const {
+	const double* sampleVectorPtr = sampleVector.ptr<double>();
+	int key = 0;
+	for(size_t i = 0; i < keyNeighbors.size(); ++i) {
+		int level = (int)(sampleVectorPtr[keyNeighbors[i]] * PATCH_INDEX_LEVELS / (maxval + 1.0)); // intensities are integers: deterministic
+		key = key * PATCH_INDEX_LEVELS + (level < 0 ? 0 : (level >= PATCH_INDEX_LEVELS ? PATCH_INDEX_LEVELS - 1 : level));
+	}
+	return key;
+} // end PatchIndex::keyOf
+
+void PatchIndex::insert(int key, const Point3i& position) {
+	if((int)buckets[key].size() < bucketSize) buckets[key].push_back(position);
+	else buckets[key][insertions[key] % bucketSize] = position; // replace oldest
+	++insertions[key];
+} // end PatchIndex::insert
+
+} // end namespace vanilc
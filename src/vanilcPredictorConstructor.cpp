@@ -43,25 +43,41 @@ Predictor* PredictorConstructor::constructNLMpredictor(Config& config, const Con
 Predictor* PredictorConstructor::constructFastLSpredictor(Config& config, const Context& context) {
 	Predictor* fastlspredictor = new Predictor(context);
 	Mat* covMat = new Mat; Mat* coefficients = new Mat; Mat* weights = new Mat;
-	fastlspredictor->setPredictionComputer(new FastLSPredictionComputer(covMat, coefficients, weights,
-		config.get<double>("border_regularization"), config.get<double>("inner_regularization"), config.get<int>("solver")));
+	LSPredictionComputer* predictionComputer;
+	if(config.get<double>("training_decay") > 0.0) // exponentially decaying training window
+		predictionComputer = new DecayLSPredictionComputer(covMat, coefficients, weights,
+			config.get<double>("border_regularization"), config.get<double>("inner_regularization"), config.get<int>("solver"),
+			config.get<int>("reestimation_interval"), config.get<double>("reestimation_threshold"), config.get<double>("training_decay"));
+	else predictionComputer = new FastLSPredictionComputer(covMat, coefficients, weights,
+		config.get<double>("border_regularization"), config.get<double>("inner_regularization"), config.get<int>("solver"),
+		config.get<int>("reestimation_interval"), config.get<double>("reestimation_threshold"), config.get<bool>("exact_integrals"));
+	fastlspredictor->setPredictionComputer(predictionComputer);
 	if(config.get<string>("variance") == "LS")
-		fastlspredictor->setVarianceComputer(new LSVarianceComputer(covMat, coefficients, weights, 0));
+		fastlspredictor->setVarianceComputer(new LSVarianceComputer(covMat, coefficients, weights, 0, predictionComputer));
 	else if(config.get<string>("variance") == "RESIDUAL")
 		fastlspredictor->setVarianceComputer(new ResidualVarianceComputer(config.get<double>("variance_radius")));
 	else
 		fastlspredictor->setVarianceComputer(new ExponentialVarianceComputer);
-	fastlspredictor->setDegreesOfFreedomComputer(new LSDegreesOfFreedomComputer(covMat));
+	if(config.get<double>("training_decay") > 0.0) // effective number of training pixels
+		fastlspredictor->setDegreesOfFreedomComputer(new LSDegreesOfFreedomComputer(covMat, predictionComputer));
+	else fastlspredictor->setDegreesOfFreedomComputer(new LSDegreesOfFreedomComputer(covMat));
 	return fastlspredictor;
 } // end PredictorConstructor::constructFastLSpredictor
 
 Predictor* PredictorConstructor::constructLSpredictor(Config& config, const Context& context) {
 	Predictor* lspredictor = new Predictor(context);
 	Mat* covMat = new Mat; Mat* coefficients = new Mat; Mat* weights = new Mat;
-	lspredictor->setPredictionComputer(new LSPredictionComputer(covMat, coefficients, weights, IdentityWeightingFunction(),
-		config.get<double>("border_regularization"), config.get<double>("inner_regularization"), config.get<int>("wls_variance_equation"), config.get<int>("solver"), 0));
+	LSPredictionComputer* predictionComputer;
+	if(config.get<bool>("sliding_covariance")) // incremental covariance matrix from pixel to pixel
+		predictionComputer = new SlidingLSPredictionComputer(covMat, coefficients, weights,
+			config.get<double>("border_regularization"), config.get<double>("inner_regularization"), config.get<int>("wls_variance_equation"), config.get<int>("solver"),
+			config.get<bool>("batched_covariance"), config.get<int>("reestimation_interval"), config.get<double>("reestimation_threshold"));
+	else predictionComputer = new LSPredictionComputer(covMat, coefficients, weights, IdentityWeightingFunction(),
+		config.get<double>("border_regularization"), config.get<double>("inner_regularization"), config.get<int>("wls_variance_equation"), config.get<int>("solver"), 0,
+		config.get<bool>("batched_covariance"), config.get<int>("reestimation_interval"), config.get<double>("reestimation_threshold"), false);
+	lspredictor->setPredictionComputer(predictionComputer);
 	if(config.get<string>("variance") == "LS")
-		lspredictor->setVarianceComputer(new LSVarianceComputer(covMat, coefficients, weights, 0));
+		lspredictor->setVarianceComputer(new LSVarianceComputer(covMat, coefficients, weights, 0, predictionComputer));
 	else if(config.get<string>("variance") == "RESIDUAL")
 		lspredictor->setVarianceComputer(new ResidualVarianceComputer(config.get<double>("variance_radius")));
 	else
@@ -92,26 +108,88 @@ Predictor* PredictorConstructor::constructWLSpredictor(Config& config, const Con
 		if(weightingContext) otherWeightingFunction = new InversePriorizedSQDWeightingFunction(
 			InversePriorizedSSDWeightingFunction::constructInverseEuclideanPriorization(weightingContext->getNeighborhood()) * 60.0);
 	}
+	LSPredictionComputer* predictionComputer;
 	if(weightingContext) { // different context for weight computation
-		wlspredictor->setPredictionComputer(new LSPredictionComputer(covMat, coefficients, weights, *weightingFunction,
+		predictionComputer = new LSPredictionComputer(covMat, coefficients, weights, *weightingFunction,
 			weightingContext, *otherWeightingFunction,
 			config.get<double>("border_regularization"), config.get<double>("inner_regularization"),
-			config.get<int>("wls_variance_equation"), config.get<int>("solver"), config.get<int>("max_training_vectors")));
+			config.get<int>("wls_variance_equation"), config.get<int>("solver"), config.get<int>("max_training_vectors"), config.get<bool>("batched_covariance"),
+			config.get<int>("reestimation_interval"), config.get<double>("reestimation_threshold"), config.get<bool>("patch_index"));
 		delete otherWeightingFunction;
 	} else
-		wlspredictor->setPredictionComputer(new LSPredictionComputer(covMat, coefficients, weights, *weightingFunction,
+		predictionComputer = new LSPredictionComputer(covMat, coefficients, weights, *weightingFunction,
 			config.get<double>("border_regularization"), config.get<double>("inner_regularization"),
-			config.get<int>("wls_variance_equation"), config.get<int>("solver"), config.get<int>("max_training_vectors")));
+			config.get<int>("wls_variance_equation"), config.get<int>("solver"), config.get<int>("max_training_vectors"), config.get<bool>("batched_covariance"),
+			config.get<int>("reestimation_interval"), config.get<double>("reestimation_threshold"), config.get<bool>("patch_index"));
+	wlspredictor->setPredictionComputer(predictionComputer);
 	delete weightingFunction;
 	if(config.get<string>("variance") == "LS")
-		wlspredictor->setVarianceComputer(new LSVarianceComputer(covMat, coefficients, weights, config.get<int>("wls_variance_equation")));
+		wlspredictor->setVarianceComputer(new LSVarianceComputer(covMat, coefficients, weights, config.get<int>("wls_variance_equation"), predictionComputer));
 	else if(config.get<string>("variance") == "RESIDUAL")
 		wlspredictor->setVarianceComputer(new ResidualVarianceComputer(config.get<double>("variance_radius")));
 	else
 		wlspredictor->setVarianceComputer(new ExponentialVarianceComputer);
-	wlspredictor->setDegreesOfFreedomComputer(new LSDegreesOfFreedomComputer(covMat));
+	wlspredictor->setDegreesOfFreedomComputer(new LSDegreesOfFreedomComputer(covMat, predictionComputer));
 	return wlspredictor;
 } // end PredictorConstructor::constructWLSpredictor
 
+Predictor* PredictorConstructor::constructBlockLSpredictor(Config& config, const Context& context) {
+	Predictor* blocklspredictor = new Predictor(context);
+	BlockLSPredictionComputer* predictionComputer = new BlockLSPredictionComputer(config.get<int>("block_size"), config.get<int>("block_coefficient_bits"),
+		config.get<double>("inner_regularization"), config.get<int>("solver"));
+	blocklspredictor->setPredictionComputer(predictionComputer);
+	if(config.get<string>("variance") == "RESIDUAL")
+		blocklspredictor->setVarianceComputer(new ResidualVarianceComputer(config.get<double>("variance_radius")));
+	else
+		blocklspredictor->setVarianceComputer(new ExponentialVarianceComputer);
+	blocklspredictor->setDegreesOfFreedomComputer(new BlockLSDegreesOfFreedomComputer(predictionComputer));
+	return blocklspredictor;
+} // end PredictorConstructor::constructBlockLSpredictor
+
+Predictor* PredictorConstructor::constructRLSpredictor(Config& config, const Context& context) {
+	Predictor* rlspredictor = new Predictor(context);
+	RLSPredictionComputer* predictionComputer = new RLSPredictionComputer(config.get<double>("forgetting_factor"), config.get<double>("inner_regularization"));
+	rlspredictor->setPredictionComputer(predictionComputer);
+	if(config.get<string>("variance") == "LS")
+		rlspredictor->setVarianceComputer(new RLSVarianceComputer(predictionComputer));
+	else if(config.get<string>("variance") == "RESIDUAL")
+		rlspredictor->setVarianceComputer(new ResidualVarianceComputer(config.get<double>("variance_radius")));
+	else
+		rlspredictor->setVarianceComputer(new ExponentialVarianceComputer);
+	rlspredictor->setDegreesOfFreedomComputer(new RLSDegreesOfFreedomComputer(predictionComputer));
+	return rlspredictor;
+} // end PredictorConstructor::constructRLSpredictor
+
+Predictor* PredictorConstructor::constructCascadepredictor(Config& config, const Context& context, Context* weightingContext) {
+	Predictor* cascadepredictor = new Predictor(context);
+	Predictor* flatPredictor;
+	if(config.get<string>("cascade_flat_predictor") == "MEAN")
+		flatPredictor = constructMeanpredictor(config, context);
+	else { // MED always uses the 3-pixel neighborhood
+		Context medContext;
+		medContext.setFullNeighborhood(StructuringElement::createHalfEllipseElement(1.5, 1.5, 0.5, true));
+		medContext.setFullTrainingregion(context.getFullTrainingregion());
+		medContext.setPrecision(context.getPrecision());
+		flatPredictor = constructMEDpredictor(config, medContext);
+	}
+	Predictor* moderatePredictor = constructFastLSpredictor(config, context);
+	Predictor* texturePredictor = constructWLSpredictor(config, context, weightingContext);
+	CascadePredictionComputer* predictionComputer = new CascadePredictionComputer(flatPredictor, moderatePredictor, texturePredictor,
+		config.get<double>("cascade_flat_threshold"), config.get<double>("cascade_texture_threshold"));
+	cascadepredictor->setPredictionComputer(predictionComputer);
+	flatPredictor->setVarianceComputer(new Computer); // recursive variance estimators see all pixels in the cascade predictor instead
+	if(config.get<string>("variance") == "LS")
+		cascadepredictor->setVarianceComputer(new CascadeVarianceComputer(predictionComputer));
+	else {
+		moderatePredictor->setVarianceComputer(new Computer); texturePredictor->setVarianceComputer(new Computer);
+		if(config.get<string>("variance") == "RESIDUAL")
+			cascadepredictor->setVarianceComputer(new ResidualVarianceComputer(config.get<double>("variance_radius")));
+		else
+			cascadepredictor->setVarianceComputer(new ExponentialVarianceComputer);
+	}
+	cascadepredictor->setDegreesOfFreedomComputer(new CascadeDegreesOfFreedomComputer(predictionComputer));
+	return cascadepredictor;
+} // end PredictorConstructor::constructCascadepredictor
+
 } // end namespace vanilc
 
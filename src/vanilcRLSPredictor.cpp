@@ -0,0 +1,104 @@
+// Copyright (c) 2015 Siemens AG, Author: Andreas Weinlich
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "vanilcRLSPredictor.h"
+
+namespace vanilc {
+
+void RLSPredictionComputer::init() {
+	inverseCovariance.release(); // allocated with the first full neighborhood
+	pending = false;
+	currentPos = Point3i(-1, -1, -1);
+} // end RLSPredictionComputer::init
+
+double RLSPredictionComputer::compute(const Point3i& currentPos, Context* context) {
+	if(currentPos.z != this->currentPos.z) inverseCovariance.release(); // each slice starts with a new estimate
+	else if(pending) update(context->getImage()->at<double>(this->currentPos.z, this->currentPos.y, this->currentPos.x)); // value of previous pixel is known now
+	pending = false;
+	this->currentPos = currentPos;
+	context->contextOf(currentPos, sampleVector);
+	const int numberOfNeighbors = sampleVector.cols - 1;
+	const double* samplePtr = sampleVector.ptr<double>();
+	if(numberOfNeighbors + 1 != (int)context->getFullNeighborhood().getNumberOfElements()) { // border pixel: mean prediction and conventional variance estimation
+		if(!numberOfNeighbors) {
+			neighborhoodVariance = predictor->getMaxval() * predictor->getMaxval() * .25; // first image pixel (use heuristic)
+			return (1.0 + predictor->getMaxval()) / 2.0;
+		}
+		const double neighborhoodMean = mean(sampleVector.colRange(0, numberOfNeighbors))[0];
+		if(numberOfNeighbors < 2) neighborhoodVariance = predictor->getMaxval() * predictor->getMaxval() * .0625; // second image pixel (also use heuristic)
+		else {
+			neighborhoodVariance = 0.0;
+			for(int i = 0; i < numberOfNeighbors; ++i) neighborhoodVariance += (samplePtr[i] - neighborhoodMean) * (samplePtr[i] - neighborhoodMean);
+			neighborhoodVariance /= numberOfNeighbors - 1; // unbiased sample variance
+		}
+		return neighborhoodMean;
+	}
+	if(inverseCovariance.empty()) { // first full neighborhood of the slice: P = I / regularization, mean predictor
+		numberOfCoefficients = numberOfNeighbors;
+		inverseCovariance = Mat::eye(numberOfCoefficients, numberOfCoefficients, CV_64F) / regularization;
+		coefficients = Mat(1, numberOfCoefficients, CV_64F, Scalar(1.0 / numberOfCoefficients));
+		gainVector.create(1, numberOfCoefficients, CV_64F);
+		sumOfSquaredResiduals = numberOfSamples = 0.0;
+	}
+	const double* coefficientPtr = coefficients.ptr<double>();
+	double* gainPtr = gainVector.ptr<double>();
+	prediction = errorFactor = 0.0;
+	for(int i = 0; i < numberOfCoefficients; ++i) { // P x and x' P x (P is symmetric)
+		const double* inverseCovariancePtr = inverseCovariance.ptr<double>(i);
+		gainPtr[i] = 0.0;
+		for(int j = 0; j < numberOfCoefficients; ++j) gainPtr[i] += inverseCovariancePtr[j] * samplePtr[j];
+		errorFactor += samplePtr[i] * gainPtr[i];
+		prediction += coefficientPtr[i] * samplePtr[i];
+	}
+	if(errorFactor < 0.0) errorFactor = 0.0; // numerical loss of positive definiteness
+	pending = true;
+	return (prediction < 0.0 ? 0.0 : (prediction > predictor->getMaxval() ? predictor->getMaxval() : prediction)); // crop to valid value range
+} // end RLSPredictionComputer::compute
+
+// Sherman-Morrison update of P = (lambda X'X)^-1 with the sample vector x of the previous pixel (still in sampleVector and gainVector = P x)
+void RLSPredictionComputer::update(double value) {
+	const double residual = value - prediction; // a priori error (uncropped prediction)
+	const double denominator = forgettingFactor + errorFactor;
+	const double* gainPtr = gainVector.ptr<double>();
+	double* coefficientPtr = coefficients.ptr<double>();
+	double trace = 0.0;
+	for(int i = 0; i < numberOfCoefficients; ++i) {
+		coefficientPtr[i] += gainPtr[i] * residual / denominator;
+		double* inverseCovariancePtr = inverseCovariance.ptr<double>(i);
+		for(int j = i; j < numberOfCoefficients; ++j) inverseCovariancePtr[j] -= gainPtr[i] * gainPtr[j] / denominator; // upper triangle
+		trace += inverseCovariancePtr[i];
+	}
+	// forgetting increases P in directions without excitation (e.g. flat regions) without bound: only forget while P is smaller than at the start
+	const double forgetting = (trace * forgettingFactor < numberOfCoefficients / regularization ? 1.0 / forgettingFactor : 1.0);
+	for(int i = 0; i < numberOfCoefficients; ++i) {
+		double* inverseCovariancePtr = inverseCovariance.ptr<double>(i);
+		for(int j = i; j < numberOfCoefficients; ++j) inverseCovariance.at<double>(j, i) = (inverseCovariancePtr[j] *= forgetting); // mirror to lower triangle
+	}
+	sumOfSquaredResiduals = forgettingFactor * sumOfSquaredResiduals + forgettingFactor * residual * residual / denominator; // a posteriori weighted SSR
+	numberOfSamples = forgettingFactor * numberOfSamples + 1.0;
+} // end RLSPredictionComputer::update
+
+double RLSPredictionComputer::getVariance() const {
+	if(!pending) return neighborhoodVariance;
+	if(numberOfSamples < numberOfCoefficients + 1) { // too few samples for an estimate (use conventional variance estimation)
+		const double* samplePtr = sampleVector.ptr<double>();
+		const double neighborhoodMean = mean(sampleVector.colRange(0, numberOfCoefficients))[0];
+		double variance = 0.0;
+		for(int i = 0; i < numberOfCoefficients; ++i) variance += (samplePtr[i] - neighborhoodMean) * (samplePtr[i] - neighborhoodMean);
+		return variance / (numberOfCoefficients - 1); // unbiased sample variance
+	}
+	return sumOfSquaredResiduals * (1.0 + errorFactor) / getDegreesOfFreedom(); // as in LSVarianceComputer
+} // end RLSPredictionComputer::getVariance
+
+int RLSPredictionComputer::getDegreesOfFreedom() const {
+	if(!pending) return 1;
+	const int degreesOfFreedom = (int)numberOfSamples - numberOfCoefficients;
+	return (degreesOfFreedom < 1 ? 1 : degreesOfFreedom);
+} // end RLSPredictionComputer::getDegreesOfFreedom
+
+} // end namespace vanilc
@@ -0,0 +1,73 @@
+// Copyright (c) 2015 Siemens AG, Author: Andreas Weinlich
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "vanilcSlidingLSPredictor.h"
+
+namespace vanilc {
+
+void SlidingLSPredictionComputer::init() {
+	LSPredictionComputer::init();
+	const StructuringElement& trainingregion = predictor->getContext().getFullTrainingregion();
+	trainingOffsets.clear(); enteringOffsets.clear(); leavingOffsets.clear();
+	const Point3i right(1, 0, 0);
+	for(int z = 0; z < (int)trainingregion.getSlcs(); ++z)
+		for(int y = 0; y < (int)trainingregion.getRows(); ++y)
+			for(int x = -1; x <= (int)trainingregion.getCols(); ++x) {
+				const Point3i offset = Point3i(x, y, z) - trainingregion.getAnchor();
+				if(trainingregion.contains(offset)) {
+					trainingOffsets.push_back(offset);
+					if(!trainingregion.contains(offset + right)) enteringOffsets.push_back(offset); // not in the training region of the previous pixel
+				} else if(trainingregion.contains(offset + right)) leavingOffsets.push_back(offset); // only in the training region of the previous pixel
+			}
+	const int numberOfElements = predictor->getContext().getFullNeighborhood().getNumberOfElements();
+	sums.assign(numberOfElements * (numberOfElements + 1) / 2, 0);
+	maxSteps = (int)trainingOffsets.size() / max(1, (int)(enteringOffsets.size() + leavingOffsets.size()));
+	sumPos = Point3i(-1, -1, -1);
+} // end SlidingLSPredictionComputer::init
+
+// estimate covariance matrix
+void SlidingLSPredictionComputer::estimate(const Point3i& currentPos) {
+	if(context->getNeighborhood().getNumberOfElements() != context->getFullNeighborhood().getNumberOfElements()
+		|| context->getTrainingregion().getNumberOfElements() != context->getFullTrainingregion().getNumberOfElements()) {
+			LSPredictionComputer::estimate(currentPos); // cropped at the border
+			return;
+	}
+	if(sumPos.z == currentPos.z && sumPos.y == currentPos.y && sumPos.x < currentPos.x && currentPos.x - sumPos.x <= maxSteps) {
+		for(; sumPos.x < currentPos.x; ++sumPos.x) { // all pixels in between have an uncropped training region, too
+			for(size_t i = 0; i < leavingOffsets.size(); ++i) accumulate(sumPos + Point3i(1, 0, 0) + leavingOffsets[i], -1);
+			for(size_t i = 0; i < enteringOffsets.size(); ++i) accumulate(sumPos + Point3i(1, 0, 0) + enteringOffsets[i], 1);
+		}
+	} else { // new row or too far away: sum up the whole training region
+		fill(sums.begin(), sums.end(), 0);
+		for(size_t i = 0; i < trainingOffsets.size(); ++i) accumulate(currentPos + trainingOffsets[i], 1);
+		sumPos = currentPos;
+	}
+	const int numberOfElements = context->getFullNeighborhood().getNumberOfElements();
+	context->contextOf(currentPos, sampleVector); // get current neighborhood and store it in sampleVector
+	covMat->create(numberOfElements, numberOfElements + 1, CV_64F); // one more row for later variance estimation!
+	sampleVector.reshape(0, sampleVector.cols).copyTo(covMat->col(covMat->cols - 1)); // put neighborhood in last column for variance estimate
+	const int64* sumPtr = &sums[0];
+	for(int k = 0; k < numberOfElements; ++k) {
+		double* covMatPtr = covMat->ptr<double>(k);
+		for(int l = k; l < numberOfElements; ++l) covMatPtr[l] = covMat->at<double>(l, k) = (double)*(sumPtr++);
+	}
+	*covMat = covMat->rowRange(0, covMat->rows - 1); // make last row invisible for computePrediction function of WLS
+	*weights = weights->colRange(0, 0); // set used region
+} // end SlidingLSPredictionComputer::estimate
+
+void SlidingLSPredictionComputer::accumulate(const Point3i& position, int64 sign) {
+	context->contextOf(position, sampleVector);
+	const double* const samplePtr = sampleVector.ptr<double>();
+	int64* sumPtr = &sums[0];
+	for(int k = 0; k < sampleVector.cols; ++k) {
+		const int64 value = sign * (int64)cvRound(samplePtr[k]); // pixel values are integers
+		for(int l = k; l < sampleVector.cols; ++l) *(sumPtr++) += value * (int64)cvRound(samplePtr[l]);
+	}
+} // end SlidingLSPredictionComputer::accumulate
+
+} // end namespace vanilc
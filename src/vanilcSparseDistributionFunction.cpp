@@ -18,13 +18,14 @@ void SparseDistributionFunction::setParameters(Mat parameters, unsigned int crop
 	if(l) previousPosition = Point3i(l - 1, k, j);
 	else if(k) previousPosition = Point3i(image->size[2] - 1, k - 1, j);
 	else previousPosition = Point3i(image->size[2] - 1, image->size[1] - 1, j - 1);
-	if(previousPosition.z > -1) previousImageIntensity = (unsigned int)(image->at<double>(previousPosition.z, previousPosition.y, previousPosition.x));
+	const bool isFirstPosition = (Point3i(l, k, j) == firstPosition);
+	if(previousPosition.z > -1 && !isFirstPosition) previousImageIntensity = (unsigned int)(image->at<double>(previousPosition.z, previousPosition.y, previousPosition.x));
 //	if(k > 0 && computeValue((double)previousImageIntensity + .5) - computeValue((double)previousImageIntensity - .5) < 1e-14)
 //		protectionMap.at<unsigned int>(previousPosition.y, previousPosition.x) = 1;
 //	if(k == image->size[1] - 1 && l == image->size[2] - 1) cout << "[" << countNonZero(protectionMap) << "]";
 	basicDist->setParameters(parameters, cropped);
 	// longterm histogram creation and unprobable value detection
-	if(independentSlices && k == 0 && l == 0) {
+	if(independentSlices && k == 0 && l == 0 || isFirstPosition) {
 		longtermHistogram = Scalar_<int>(0);
 		longtermTestarray = Scalar(0.0);
 		smallestNumberOfPixelsWithSameIntensityInPast = image->total();
@@ -139,17 +139,26 @@ Mat StructuringElement::extractVectorFromImage(const Mat& image, const Point3i&
 } // end StructuringElement::extractVectorFromImage
 
 void StructuringElement::extractVectorFromImage(const Mat& image, Point3i position, double* destination) const {
+	extractVector(image, position, destination);
+} // end StructuringElement::extractVectorFromImage
+
+void StructuringElement::extractVectorFromImage(const Mat& image, Point3i position, float* destination) const {
+	extractVector(image, position, destination);
+} // end StructuringElement::extractVectorFromImage
+
+template<typename T>
+void StructuringElement::extractVector(const Mat& image, Point3i position, T* destination) const {
 	position -= anchor;
 	for(int j = 0; j < mask.size[0]; ++j)
 		for(int k = 0; k < mask.size[1]; ++k) {
 			const uchar* maskPtr = &(mask.at<uchar>(j, k, 0));
 			const double* patchPtr = &(image.at<double>(position.z + j, position.y + k, position.x));
 			for(int l = 0; l < mask.size[2]; ++l) {
-				if(*(maskPtr++)) *(destination++) = *(patchPtr++);
+				if(*(maskPtr++)) *(destination++) = (T)*(patchPtr++);
 				else ++patchPtr;
 			}
 		}
-} // end StructuringElement::extractVectorFromImage
+} // end StructuringElement::extractVector
 
 void StructuringElement::extractVectorFromImageBorderSafe(const Mat& image, const Point3i& position, Mat& destination) {
 	destination.create(1, numel, CV_64F);
@@ -171,6 +180,19 @@ void StructuringElement::extractVectorFromImageBorderSafe(const Mat& image, cons
 	if(total != mask.total()) { setMask(oldMask); anchor = oldAnchor; }
 } // end StructuringElement::extractVectorFromImageBorderSafe
 
+void StructuringElement::extractVectorFromImageZeroPadded(const Mat& image, const Point3i& position, double* destination) const {
+	const Point3i start = position - anchor;
+	if(start.x >= 0 && start.y >= 0 && start.z >= 0 && start.x + mask.size[2] <= image.size[2] && start.y + mask.size[1] <= image.size[1]
+		&& start.z + mask.size[0] <= image.size[0]) { extractVector(image, position, destination); return; } // completely inside of the image
+	for(int j = 0; j < mask.size[0]; ++j)
+		for(int k = 0; k < mask.size[1]; ++k) {
+			const uchar* maskPtr = &(mask.at<uchar>(j, k, 0));
+			const bool inside = (start.z + j >= 0 && start.z + j < image.size[0] && start.y + k >= 0 && start.y + k < image.size[1]);
+			for(int l = 0; l < mask.size[2]; ++l)
+				if(*(maskPtr++)) *(destination++) = (inside && start.x + l >= 0 && start.x + l < image.size[2] ? image.at<double>(start.z + j, start.y + k, start.x + l) : 0.0);
+		}
+} // end StructuringElement::extractVectorFromImageZeroPadded
+
 void StructuringElement::computeHistogramFromImageBorderSafe(const Mat& image, Point3i position, Mat& histogram) {
 	Mat oldMask = mask;
 	Point3i oldAnchor = anchor;
@@ -0,0 +1,63 @@
+// Copyright (c) 2015 Siemens AG, Author: Andreas Weinlich
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "vanilcSubstream.h"
+
+namespace vanilc {
+
+Substream::Substream(Predictor* predictor, Context* weightingContext, Mat* image, unsigned int slice, const Range& rows, bool sharedBuffer) :
+	predictor(predictor),
+	weightingContext(weightingContext),
+	image(image),
+	slice(slice),
+	rows(rows),
+	sharedBuffer(sharedBuffer),
+	firstStep(0)
+	#ifdef ARITHMETIC_CODING
+		, distributionMaker(predictor->getMaxval() + 2),
+		regDistRatio(0.0),
+		regDistVar(1.0),
+		sparse(false)
+	#endif
+{
+	#ifdef ARITHMETIC_CODING
+		entropyCoder.setDistribution(distributionMaker.getImplicitDistribution());
+	#endif
+} // end Substream::Substream
+
+Substream::~Substream() {
+	delete predictor;
+	if(weightingContext) delete weightingContext;
+} // end Substream::~Substream
+
+void Substream::codeSegment(unsigned int segment, bool encoding) {
+	const int k = rows.start + segment / getSegmentsPerRow();
+	const int firstCol = segment % getSegmentsPerRow() * SUBSTREAM_SEGMENT_WIDTH, lastCol = min(firstCol + (int)SUBSTREAM_SEGMENT_WIDTH, image->size[2]);
+	for(int l = firstCol; l < lastCol; ++l) {
+		const double prediction = predictor->computePrediction(Point3i(l, k, slice));
+		const double variance = predictor->computeVariance();
+		const double dof = predictor->computeDegreesOfFreedom();
+		#ifdef ARITHMETIC_CODING
+			if(sparse) distributionMaker.getDistributionFunction(0)->setParameters(
+				(Mat_<double>(7, 1) << (1.0 - regDistRatio), prediction, variance, dof, (double)slice, (double)k, (double)l));
+			else distributionMaker.getDistributionFunction(0)->setParameters((Mat_<double>(4, 1) << (1.0 - regDistRatio), prediction, variance, dof));
+			distributionMaker.getDistributionFunction(1)->setParameters((Mat_<double>(3, 1) << regDistRatio, prediction, regDistVar), predictor->getMaxval());
+		#elif defined GOLOMB_CODING
+			entropyCoder.setParameters(prediction, variance);
+		#endif
+		entropyCoder.code(image->at<double>(slice, k, l), encoding);
+		if(sharedBuffer) predictor->fillBuffer(slice, Range(k, k + 1), Range(l, l + 1)); // other substreams may read the buffer of this pixel in later steps
+	}
+} // end Substream::codeSegment
+
+void ParallelSubstreamCoder::operator()(const Range& range) const {
+	for(int i = range.start; i < range.end; ++i)
+		(*substreams)[i]->codeSegment(step - (*substreams)[i]->getFirstStep(), encoding);
+} // end ParallelSubstreamCoder::operator()
+
+} // end namespace vanilc